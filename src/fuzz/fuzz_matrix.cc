@@ -0,0 +1,88 @@
+// Differential fuzz target: decodes an operation, a thread count, the
+// shapes and the elements from the input, checks every optimized path of
+// the operation against S21Reference and aborts on a disagreement. Built
+// for libFuzzer by "make fuzz", or with the driver in fuzz_replay.cc by
+// "make fuzz_replay" where libFuzzer is not available.
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "s21_parallel.h"
+#include "s21_reference.h"
+
+namespace {
+
+const int kMaxProductSize = 48;
+const int kMaxThreads = 4;
+
+// Bytes taken front to back, zeros once the input runs out.
+class Input {
+ public:
+  Input(const std::uint8_t *data, std::size_t size)
+      : data_(data), size_(size) {}
+
+  int Byte() { return position_ < size_ ? data_[position_++] : 0; }
+  int Dimension(int max) { return 1 + Byte() % max; }
+  // Multiples of 1/16 in [-8, 8): products stay exact, sums round.
+  double Element() { return (Byte() - 128) / 16.0; }
+
+ private:
+  const std::uint8_t *data_;
+  std::size_t size_;
+  std::size_t position_ = 0;
+};
+
+S21Matrix Read(Input &input, int rows, int cols) {
+  S21Matrix result(rows, cols);
+  for (double &value : result) value = input.Element();
+  return result;
+}
+
+// Leaves a square matrix as it is, makes its last row nearly or exactly
+// the first one, or scales its rows apart by up to 2^31 each.
+void Skew(Input &input, S21Matrix &a) {
+  int n = a.GetRows();
+  int kind = input.Byte() % 4;
+  int gap = input.Byte() % 48;
+  for (int j = 0; j < n && n > 1 && (kind == 1 || kind == 2); ++j) {
+    double offset = kind == 1 ? std::ldexp(a(n - 1, j), -gap) : 0;
+    a(n - 1, j) = a(0, j) + offset;
+  }
+  for (int i = 0; i < n && kind == 3; ++i) {
+    int exponent = input.Byte() % 63 - 31;
+    for (double &value : a.Row(i)) value = std::ldexp(value, exponent);
+  }
+}
+
+void Check(const std::string &error) {
+  if (error.empty()) return;
+  std::fprintf(stderr, "%s\n", error.c_str());
+  std::abort();
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data,
+                                      std::size_t size) {
+  Input input(data, size);
+  int operation = input.Byte() % 3;
+  S21Parallel::SetNumThreads(1 + input.Byte() % kMaxThreads);
+  if (operation == 0) {
+    int m = input.Dimension(kMaxProductSize);
+    int k = input.Dimension(kMaxProductSize);
+    int n = input.Dimension(kMaxProductSize);
+    S21Matrix a = Read(input, m, k);
+    S21Matrix b = Read(input, k, n);
+    Check(S21Reference::CheckProduct(a, b));
+  } else {
+    int n = input.Dimension(S21Reference::kMaxCofactorSize);
+    S21Matrix a = Read(input, n, n);
+    Skew(input, a);
+    Check(operation == 1 ? S21Reference::CheckDeterminant(a)
+                         : S21Reference::CheckInverse(a));
+  }
+  return 0;
+}
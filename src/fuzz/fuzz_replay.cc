@@ -0,0 +1,43 @@
+// Runs the fuzz target without libFuzzer: once on each file named on the
+// command line, such as a crash input saved by libFuzzer, or with no
+// arguments on kInputs pseudo-random inputs.
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "s21_random.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data,
+                                      std::size_t size);
+
+namespace {
+
+const int kInputs = 2000;
+const std::size_t kMaxInputBlocks = 320;  // 16 bytes each
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  for (int i = 1; i < argc; ++i) {
+    std::ifstream file(argv[i], std::ios::binary);
+    std::vector<std::uint8_t> input((std::istreambuf_iterator<char>(file)),
+                                    std::istreambuf_iterator<char>());
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+  }
+  if (argc > 1) return 0;
+  for (int i = 0; i < kInputs; ++i) {
+    S21Philox generator(i);
+    std::uint32_t length[S21Philox::kWordsPerBlock];
+    generator.Block(0, length);
+    std::size_t blocks = 1 + length[0] % kMaxInputBlocks;
+    std::vector<std::uint32_t> words(blocks * S21Philox::kWordsPerBlock);
+    generator.Blocks(1, blocks, words.data());
+    LLVMFuzzerTestOneInput(reinterpret_cast<std::uint8_t *>(words.data()),
+                           words.size() * sizeof(std::uint32_t));
+  }
+  std::printf("%d inputs passed\n", kInputs);
+  return 0;
+}
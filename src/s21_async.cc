@@ -0,0 +1,223 @@
+#include "s21_async.h"
+
+#include <atomic>
+
+#include "s21_status.h"
+
+// S21Future
+
+struct S21Future::State {
+  std::mutex mutex;
+  std::condition_variable done_signal;
+  bool done = false;
+  std::optional<S21Matrix> value;
+  std::exception_ptr error;
+  std::vector<std::function<void()>> continuations;
+
+  // Runs callback once the state is done, immediately if it already is.
+  void OnDone(std::function<void()> callback) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!done) {
+        continuations.push_back(std::move(callback));
+        return;
+      }
+    }
+    callback();
+  }
+
+  void Finish(std::optional<S21Matrix> result, std::exception_ptr failure) {
+    std::vector<std::function<void()>> callbacks;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      value = std::move(result);
+      error = failure;
+      done = true;
+      callbacks.swap(continuations);
+    }
+    done_signal.notify_all();
+    for (auto &callback : callbacks) callback();
+  }
+};
+
+S21Future::S21Future(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+bool S21Future::Valid() const { return state_ != nullptr; }
+
+bool S21Future::Ready() const {
+  if (!state_) return false;
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->done;
+}
+
+void S21Future::Wait() const {
+  if (!state_) {
+    S21Throw(S21Status::kInvalidArgument, "Future has no associated task.");
+  }
+  std::unique_lock<std::mutex> lock(state_->mutex);
+  state_->done_signal.wait(lock, [this] { return state_->done; });
+}
+
+const S21Matrix &S21Future::Get() const {
+  Wait();
+  if (state_->error) std::rethrow_exception(state_->error);
+  return *state_->value;
+}
+
+// S21Executor
+
+struct S21Executor::Node {
+  std::vector<S21Future> dependencies;
+  Task task;
+  std::shared_ptr<S21Future::State> state;
+  std::atomic<std::size_t> pending{0};
+};
+
+S21Executor::S21Executor(int threads) {
+  if (threads < 1) {
+    threads = static_cast<int>(std::thread::hardware_concurrency());
+    if (threads < 1) threads = 1;
+  }
+  for (int i = 0; i < threads; ++i) {
+    workers_.emplace_back(&S21Executor::WorkerLoop, this);
+  }
+}
+
+S21Executor::~S21Executor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  has_work_.notify_all();
+  for (std::thread &worker : workers_) worker.join();
+}
+
+S21Executor &S21Executor::Default() {
+  static S21Executor executor;
+  return executor;
+}
+
+S21Future S21Executor::Submit(std::vector<S21Future> dependencies,
+                              Task task) {
+  for (const S21Future &dependency : dependencies) {
+    if (!dependency.Valid()) {
+      S21Throw(S21Status::kInvalidArgument,
+               "Dependency future has no associated task.");
+    }
+  }
+  auto node = std::make_shared<Node>();
+  node->dependencies = std::move(dependencies);
+  node->task = std::move(task);
+  node->state = std::make_shared<S21Future::State>();
+  // One extra count keeps the node from starting before every dependency
+  // has registered its callback.
+  node->pending = node->dependencies.size() + 1;
+  auto release = [this, node] {
+    if (--node->pending == 0) Enqueue(node);
+  };
+  for (const S21Future &dependency : node->dependencies) {
+    dependency.state_->OnDone(release);
+  }
+  S21Future result(node->state);
+  release();
+  return result;
+}
+
+S21Future S21Executor::Submit(std::function<S21Matrix()> task) {
+  return Submit({}, [task = std::move(task)](
+                        const std::vector<const S21Matrix *> &) {
+    return task();
+  });
+}
+
+S21Future S21Executor::MakeReady(S21Matrix value) {
+  auto state = std::make_shared<S21Future::State>();
+  state->Finish(std::move(value), nullptr);
+  return S21Future(state);
+}
+
+void S21Executor::Enqueue(std::shared_ptr<Node> node) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(std::move(node));
+  }
+  has_work_.notify_one();
+}
+
+void S21Executor::WorkerLoop() {
+  for (;;) {
+    std::shared_ptr<Node> node;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      has_work_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+      if (queue_.empty()) return;
+      node = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    Run(*node);
+  }
+}
+
+void S21Executor::Run(Node &node) {
+  std::optional<S21Matrix> result;
+  std::exception_ptr failure;
+  S21_TRY {
+    std::vector<const S21Matrix *> operands;
+    operands.reserve(node.dependencies.size());
+    for (const S21Future &dependency : node.dependencies) {
+      operands.push_back(&dependency.Get());
+    }
+    result.emplace(node.task(operands));
+  }
+  S21_CATCH_ALL { failure = std::current_exception(); }
+  node.dependencies.clear();
+  node.state->Finish(std::move(result), failure);
+}
+
+// S21Async
+
+S21Future S21Async::Sum(const S21Future &a, const S21Future &b,
+                        S21Executor &executor) {
+  return executor.Submit({a, b}, [](const std::vector<const S21Matrix *> &m) {
+    S21Matrix result(*m[0]);
+    result.SumMatrix(*m[1]);
+    return result;
+  });
+}
+
+S21Future S21Async::Sub(const S21Future &a, const S21Future &b,
+                        S21Executor &executor) {
+  return executor.Submit({a, b}, [](const std::vector<const S21Matrix *> &m) {
+    S21Matrix result(*m[0]);
+    result.SubMatrix(*m[1]);
+    return result;
+  });
+}
+
+S21Future S21Async::Mul(const S21Future &a, const S21Future &b,
+                        S21Executor &executor) {
+  return executor.Submit({a, b}, [](const std::vector<const S21Matrix *> &m) {
+    S21Matrix result(*m[0]);
+    result.MulMatrix(*m[1]);
+    return result;
+  });
+}
+
+S21Future S21Async::Transpose(const S21Future &a, S21Executor &executor) {
+  return executor.Submit({a}, [](const std::vector<const S21Matrix *> &m) {
+    return m[0]->Transpose();
+  });
+}
+
+S21Future S21Async::Inverse(const S21Future &a, S21Executor &executor) {
+  return executor.Submit({a}, [](const std::vector<const S21Matrix *> &m) {
+    return m[0]->InverseMatrix(S21Matrix::Precision::kDouble);
+  });
+}
+
+S21Future S21Async::Solve(const S21Future &a, const S21Future &b,
+                          S21Executor &executor) {
+  return executor.Submit({a, b}, [](const std::vector<const S21Matrix *> &m) {
+    return m[0]->Solve(*m[1]);
+  });
+}
@@ -0,0 +1,89 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_ASYNC_H
+#define CPP1_S21_MATRIXPLUS_S21_ASYNC_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Shared handle to a matrix produced by a task on an S21Executor. Copies
+// refer to the same result.
+class S21Future {
+ public:
+  S21Future() = default;  // Invalid handle
+
+  bool Valid() const;
+  bool Ready() const;
+  void Wait() const;
+  // Waits for the result; rethrows the exception thrown by the task.
+  const S21Matrix &Get() const;
+
+ private:
+  friend class S21Executor;
+  struct State;
+  explicit S21Future(std::shared_ptr<State> state);
+
+  std::shared_ptr<State> state_;
+};
+
+// Fixed pool of worker threads running matrix tasks. A task is queued only
+// after all of its dependencies have finished, so workers never block on
+// one another and a whole graph of operations can be submitted at once.
+class S21Executor {
+ public:
+  // Receives the results of the dependencies, in submission order.
+  using Task = std::function<S21Matrix(const std::vector<const S21Matrix *> &)>;
+
+  explicit S21Executor(int threads = 0);  // 0 uses the hardware concurrency
+  S21Executor(const S21Executor &) = delete;
+  S21Executor &operator=(const S21Executor &) = delete;
+  ~S21Executor();  // Finishes queued tasks, then joins the workers
+
+  static S21Executor &Default();
+
+  S21Future Submit(std::vector<S21Future> dependencies, Task task);
+  S21Future Submit(std::function<S21Matrix()> task);
+  // Already completed future holding value.
+  static S21Future MakeReady(S21Matrix value);
+
+ private:
+  struct Node;
+
+  void Enqueue(std::shared_ptr<Node> node);
+  void WorkerLoop();
+  static void Run(Node &node);
+
+  std::mutex mutex_;
+  std::condition_variable has_work_;
+  std::deque<std::shared_ptr<Node>> queue_;
+  bool stopping_ = false;
+  std::vector<std::thread> workers_;
+};
+
+// Matrix operations on futures. Each call returns immediately; the work is
+// scheduled on the executor once its operands are available. If an operand
+// task failed, the dependent futures rethrow its exception.
+class S21Async {
+ public:
+  static S21Future Sum(const S21Future &a, const S21Future &b,
+                       S21Executor &executor = S21Executor::Default());
+  static S21Future Sub(const S21Future &a, const S21Future &b,
+                       S21Executor &executor = S21Executor::Default());
+  static S21Future Mul(const S21Future &a, const S21Future &b,
+                       S21Executor &executor = S21Executor::Default());
+  static S21Future Transpose(const S21Future &a,
+                             S21Executor &executor = S21Executor::Default());
+  static S21Future Inverse(const S21Future &a,
+                           S21Executor &executor = S21Executor::Default());
+  static S21Future Solve(const S21Future &a, const S21Future &b,
+                         S21Executor &executor = S21Executor::Default());
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_ASYNC_H
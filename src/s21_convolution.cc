@@ -0,0 +1,358 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_parallel.h"
+#include "s21_status.h"
+
+namespace {
+
+using Complex = std::complex<double>;
+using Mode = S21Matrix::ConvolutionMode;
+using Method = S21Matrix::ConvolutionMethod;
+
+// Kernels with at most this many taps always take the direct loops, which
+// need no extra memory.
+const int kDirectTaps = 49;
+
+// kAuto switches to the FFT once the direct multiply-adds exceed this many
+// times N log2 N for the padded transform size N; measured crossovers fall
+// between 5 and 10 from 64 x 64 to 1024 x 1024 matrices. im2col is never
+// picked: against a single kernel its product is a matrix-vector one and
+// streams the unrolled windows once more than the direct loops do.
+const double kFftRatio = 8;
+
+// Output elements times taps per chunk below which the loops stay serial.
+const std::size_t kParallelWork = 1 << 15;
+
+// Elements of the unrolled window matrix built per output tile by im2col.
+const std::size_t kPatchElements = 1 << 18;
+
+// Part of the full correlation kept by a mode, in full-output coordinates:
+// full(i, j) = sum_uv a(i + u - (p - 1), j + v - (q - 1)) * k(u, v).
+struct Window {
+  int row;
+  int col;
+  int rows;
+  int cols;
+};
+
+Window MakeWindow(int m, int n, int p, int q, Mode mode) {
+  switch (mode) {
+    case Mode::kSame:
+      return {(p - 1) / 2, (q - 1) / 2, m, n};
+    case Mode::kValid:
+      if (p > m || q > n) {
+        S21Throw(S21Status::kDimensionMismatch,
+                 "The kernel is larger than the matrix.");
+      }
+      return {p - 1, q - 1, m - p + 1, n - q + 1};
+    case Mode::kFull:
+      break;
+  }
+  return {0, 0, m + p - 1, n + q - 1};
+}
+
+std::size_t RowGrain(const Window &w, int taps) {
+  std::size_t row_work = static_cast<std::size_t>(w.cols) * taps;
+  return std::max<std::size_t>(1, kParallelWork / row_work);
+}
+
+// Columns c of an output row for which a(., c + shift) lies in the matrix.
+inline void ColumnRange(const Window &w, int n, int shift, int *first,
+                        int *last) {
+  *first = std::max(0, -shift);
+  *last = std::min(w.cols, n - shift);
+}
+
+// Sum of the taps that fall inside the matrix for one output element.
+inline double ClippedTaps(const double *a, int m, int n, const double *k,
+                          int p, int q, int i, int j) {
+  double sum = 0;
+  for (int u = std::max(0, -i); u < std::min(p, m - i); ++u) {
+    const double *arow = a + static_cast<std::size_t>(i + u) * n + j;
+    for (int v = std::max(0, -j); v < std::min(q, n - j); ++v) {
+      sum += k[u * q + v] * arow[v];
+    }
+  }
+  return sum;
+}
+
+// Output-stationary: kLanes neighbouring outputs of a row accumulate in
+// registers over all taps, a fixed-length inner loop the compiler turns
+// into SIMD multiply-adds. Columns whose window crosses the left or right
+// border go through ClippedTaps() instead.
+void Direct(const double *a, int m, int n, const double *k, int p, int q,
+            const Window &w, double *out) {
+  const int kLanes = 8;
+  int shift = w.col - (q - 1);  // Matrix column of tap v = 0 for output 0
+  int inner_first = std::min(w.cols, std::max(0, -shift));
+  int inner_last = std::max(inner_first, std::min(w.cols, n - q + 1 - shift));
+  S21Parallel::For(0, w.rows, RowGrain(w, p * q), [&](std::size_t first,
+                                                      std::size_t last) {
+    for (std::size_t r = first; r < last; ++r) {
+      double *orow = out + r * w.cols;
+      int i = w.row + static_cast<int>(r) - (p - 1);
+      int u_first = std::max(0, -i);
+      int u_last = std::min(p, m - i);
+      int c = inner_first;
+      for (; c + kLanes <= inner_last; c += kLanes) {
+        double acc[kLanes] = {0, 0, 0, 0, 0, 0, 0, 0};
+        for (int u = u_first; u < u_last; ++u) {
+          const double *arow =
+              a + static_cast<std::size_t>(i + u) * n + c + shift;
+          const double *ku = k + u * q;
+          for (int v = 0; v < q; ++v) {
+            double kv = ku[v];
+            for (int l = 0; l < kLanes; ++l) acc[l] += kv * arow[v + l];
+          }
+        }
+        for (int l = 0; l < kLanes; ++l) orow[c + l] = acc[l];
+      }
+      for (int j = 0; j < inner_first; ++j) {
+        orow[j] = ClippedTaps(a, m, n, k, p, q, i, j + shift);
+      }
+      for (int j = c; j < w.cols; ++j) {
+        orow[j] = ClippedTaps(a, m, n, k, p, q, i, j + shift);
+      }
+    }
+  });
+}
+
+// Unrolls the windows of a tile of output rows into a taps x outputs matrix
+// and takes its product with the kernel as a 1 x taps row. Tiles run in
+// parallel; the product inside a tile then runs inline.
+void Im2col(const double *a, int m, int n, const double *k, int p, int q,
+            const Window &w, double *out) {
+  int taps = p * q;
+  S21Matrix kernel_row(1, taps);
+  std::copy(k, k + taps, kernel_row.Data());
+  std::size_t row_elements = static_cast<std::size_t>(taps) * w.cols;
+  int tile = static_cast<int>(
+      std::max<std::size_t>(1, kPatchElements / row_elements));
+  tile = std::min(tile, w.rows);
+  int tiles = (w.rows + tile - 1) / tile;
+  S21Parallel::For(0, tiles, 1, [&](std::size_t first, std::size_t last) {
+    for (std::size_t t = first; t < last; ++t) {
+      int r_first = static_cast<int>(t) * tile;
+      int r_last = std::min(w.rows, r_first + tile);
+      int count = (r_last - r_first) * w.cols;
+      S21Matrix patch(taps, count);
+      double *pd = patch.Data();
+      for (int u = 0; u < p; ++u) {
+        for (int v = 0; v < q; ++v) {
+          double *prow = pd + static_cast<std::size_t>(u * q + v) * count;
+          int shift = w.col + v - (q - 1);
+          int c_first = 0;
+          int c_last = 0;
+          ColumnRange(w, n, shift, &c_first, &c_last);
+          for (int r = r_first; r < r_last; ++r) {
+            int i = w.row + r + u - (p - 1);
+            if (i < 0 || i >= m || c_first >= c_last) continue;
+            const double *arow = a + static_cast<std::size_t>(i) * n + shift;
+            std::copy(arow + c_first, arow + c_last,
+                      prow + (r - r_first) * w.cols + c_first);
+          }
+        }
+      }
+      const S21Matrix product = kernel_row * patch;
+      std::copy(product.Data(), product.Data() + count,
+                out + static_cast<std::size_t>(r_first) * w.cols);
+    }
+  });
+}
+
+// Spelled out: std::complex multiplication goes through a NaN-checking
+// library call unless built with -ffast-math.
+inline Complex Mul(Complex x, Complex y) {
+  return {x.real() * y.real() - x.imag() * y.imag(),
+          x.real() * y.imag() + x.imag() * y.real()};
+}
+
+int NextPowerOfTwo(int value) {
+  int power = 1;
+  while (power < value) power <<= 1;
+  return power;
+}
+
+// Radix-2 FFT of a power-of-two length n, in place. twiddles holds
+// exp(-2 pi i j / n) for j < n / 2; the inverse is left unscaled.
+class Fft {
+ public:
+  explicit Fft(int n) : n_(n), twiddles_(n / 2) {
+    const double kPi = std::acos(-1.0);
+    for (int j = 0; j < n / 2; ++j) {
+      twiddles_[j] = std::polar(1.0, -2 * kPi * j / n);
+    }
+  }
+
+  void Transform(Complex *x, bool inverse) const {
+    for (int i = 1, j = 0; i < n_; ++i) {
+      int bit = n_ >> 1;
+      for (; j & bit; bit >>= 1) j ^= bit;
+      j |= bit;
+      if (i < j) std::swap(x[i], x[j]);
+    }
+    for (int half = 1; half < n_; half <<= 1) {
+      int step = n_ / (2 * half);
+      for (int i = 0; i < n_; i += 2 * half) {
+        for (int j = 0; j < half; ++j) {
+          Complex twiddle = twiddles_[j * step];
+          if (inverse) twiddle = std::conj(twiddle);
+          Complex t = Mul(twiddle, x[i + j + half]);
+          x[i + j + half] = x[i + j] - t;
+          x[i + j] += t;
+        }
+      }
+    }
+  }
+
+ private:
+  int n_;
+  std::vector<Complex> twiddles_;
+};
+
+// The 2D transforms run along rows, then along columns, of a row-major
+// block with 'cols' columns. Rows past the input are all zero on the way
+// in and unused on the way out, so only [row_first, row_last) is touched.
+void TransformRows(const Fft &fft, Complex *data, int cols, int row_first,
+                   int row_last, bool inverse) {
+  std::size_t grain = std::max(1, (1 << 12) / cols);
+  S21Parallel::For(row_first, row_last, grain, [&](std::size_t first,
+                                                   std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+      fft.Transform(data + i * cols, inverse);
+    }
+  });
+}
+
+// Columns are gathered kBlock at a time, so every pass over a row reads a
+// whole cache line instead of one element.
+void TransformColumns(const Fft &fft, Complex *data, int rows, int cols,
+                      bool inverse) {
+  const int kBlock = 8;
+  int blocks = (cols + kBlock - 1) / kBlock;
+  std::size_t grain = std::max(1, (1 << 12) / (rows * kBlock));
+  S21Parallel::For(0, blocks, grain, [&](std::size_t first,
+                                         std::size_t last) {
+    std::vector<Complex> buffer(static_cast<std::size_t>(kBlock) * rows);
+    for (std::size_t block = first; block < last; ++block) {
+      int j_first = static_cast<int>(block) * kBlock;
+      int width = std::min(kBlock, cols - j_first);
+      for (int i = 0; i < rows; ++i) {
+        const Complex *row = data + static_cast<std::size_t>(i) * cols;
+        for (int b = 0; b < width; ++b) buffer[b * rows + i] = row[j_first + b];
+      }
+      for (int b = 0; b < width; ++b) {
+        fft.Transform(buffer.data() + b * rows, inverse);
+      }
+      for (int i = 0; i < rows; ++i) {
+        Complex *row = data + static_cast<std::size_t>(i) * cols;
+        for (int b = 0; b < width; ++b) row[j_first + b] = buffer[b * rows + i];
+      }
+    }
+  });
+}
+
+// Full correlation as the convolution with the rotated kernel, zero-padded
+// to powers of two. Both real inputs share one complex transform, the
+// matrix as the real part and the kernel as the imaginary part, so with
+// Z = A + iK the spectrum product is A K = (Z(f)^2 - conj(Z(-f))^2) / 4i.
+// The inverse transform only runs along the rows the window keeps.
+void FftCorrelate(const double *a, int m, int n, const double *k, int p,
+                  int q, const Window &w, double *out) {
+  int rows = NextPowerOfTwo(m + p - 1);
+  int cols = NextPowerOfTwo(n + q - 1);
+  std::vector<Complex> z(static_cast<std::size_t>(rows) * cols);
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < n; ++j) z[i * cols + j] = a[i * n + j];
+  }
+  for (int i = 0; i < p; ++i) {
+    for (int j = 0; j < q; ++j) {
+      z[i * cols + j] += Complex(0, k[(p - 1 - i) * q + (q - 1 - j)]);
+    }
+  }
+  Fft row_fft(cols);
+  Fft column_fft(rows);
+  TransformRows(row_fft, z.data(), cols, 0, std::max(m, p), false);
+  TransformColumns(column_fft, z.data(), rows, cols, false);
+
+  // Frequencies f and -f read each other, so each pair of mirror rows is
+  // rewritten by one thread.
+  double scale = 0.25 / (static_cast<double>(rows) * cols);
+  auto product = [scale](Complex z_f, Complex z_minus_f) {
+    Complex d = Mul(z_f, z_f) - std::conj(Mul(z_minus_f, z_minus_f));
+    return Complex(d.imag() * scale, -d.real() * scale);
+  };
+  S21Parallel::For(0, rows / 2 + 1, 8, [&](std::size_t first,
+                                           std::size_t last) {
+    for (std::size_t f = first; f < last; ++f) {
+      Complex *row = z.data() + f * cols;
+      Complex *mirror = z.data() + ((rows - f) % rows) * cols;
+      for (int j = 0; j < cols; ++j) {
+        int mj = (cols - j) % cols;
+        if (row == mirror && mj < j) continue;
+        Complex x = row[j];
+        Complex y = mirror[mj];
+        row[j] = product(x, y);
+        mirror[mj] = product(y, x);
+      }
+    }
+  });
+
+  TransformColumns(column_fft, z.data(), rows, cols, true);
+  TransformRows(row_fft, z.data(), cols, w.row, w.row + w.rows, true);
+  for (int r = 0; r < w.rows; ++r) {
+    const Complex *zrow = z.data() + (w.row + r) * cols + w.col;
+    for (int c = 0; c < w.cols; ++c) out[r * w.cols + c] = zrow[c].real();
+  }
+}
+
+Method ChooseMethod(int m, int n, int p, int q, const Window &w) {
+  if (p * q <= kDirectTaps) return Method::kDirect;
+  double rows = NextPowerOfTwo(m + p - 1);
+  double cols = NextPowerOfTwo(n + q - 1);
+  double fft_cost = rows * cols * std::log2(rows * cols);
+  double direct_cost = static_cast<double>(w.rows) * w.cols * p * q;
+  return direct_cost > kFftRatio * fft_cost ? Method::kFft : Method::kDirect;
+}
+
+S21Matrix Correlate(const S21Matrix &a, const double *k, int p, int q,
+                    Mode mode, Method method) {
+  int m = a.GetRows();
+  int n = a.GetCols();
+  Window w = MakeWindow(m, n, p, q, mode);
+  if (method == Method::kAuto) method = ChooseMethod(m, n, p, q, w);
+  S21Matrix result(w.rows, w.cols);
+  double *out = result.Data();
+  if (method == Method::kFft) {
+    FftCorrelate(a.Data(), m, n, k, p, q, w, out);
+  } else if (method == Method::kIm2col) {
+    Im2col(a.Data(), m, n, k, p, q, w, out);
+  } else {
+    Direct(a.Data(), m, n, k, p, q, w, out);
+  }
+  return result;
+}
+
+}  // namespace
+
+S21Matrix S21Matrix::Correlate2D(const S21Matrix &kernel,
+                                 ConvolutionMode mode,
+                                 ConvolutionMethod method) const {
+  return Correlate(*this, kernel.Data(), kernel.rows_, kernel.cols_, mode,
+                   method);
+}
+
+// The row-major block reversed is the kernel rotated by 180 degrees.
+S21Matrix S21Matrix::Convolve2D(const S21Matrix &kernel,
+                                ConvolutionMode mode,
+                                ConvolutionMethod method) const {
+  std::vector<double> rotated(kernel.Data(),
+                              kernel.Data() + kernel.rows_ * kernel.cols_);
+  std::reverse(rotated.begin(), rotated.end());
+  return Correlate(*this, rotated.data(), kernel.rows_, kernel.cols_, mode,
+                   method);
+}
@@ -0,0 +1,434 @@
+#include "s21_decomposition.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+
+#include "s21_parallel.h"
+#include "s21_status.h"
+#include "s21_structured.h"
+
+namespace {
+
+const int kMaxSweeps = 60;
+// Extra columns sampled by the randomized solvers, and the number of power
+// iterations used to sharpen the sampled subspace.
+const int kOversampling = 10;
+const int kPowerIterations = 3;
+const std::size_t kGrainRows = 32;
+// Householder steps of fewer multiply-adds than this per chunk stay serial.
+const std::size_t kParallelWork = 1 << 15;
+
+struct Rotation {
+  int col;
+  double c, s;
+};
+
+// Householder reduction of the symmetric matrix v to tridiagonal form
+// (EISPACK tred2). On return d is the diagonal, e the subdiagonal in
+// e[1..n-1], and v the accumulated orthogonal transformation. The product
+// with the reflector and the rank-2 update of each step are split over
+// rows of the lower triangle, so both run in parallel.
+void Tridiagonalize(S21Matrix &v, std::vector<double> &d,
+                    std::vector<double> &e) {
+  int n = v.GetRows();
+  d.assign(v[n - 1], v[n - 1] + n);
+  e.assign(n, 0.0);
+  for (int i = n - 1; i > 0; --i) {
+    double scale = 0, h = 0;
+    for (int k = 0; k < i; ++k) scale += std::abs(d[k]);
+    if (scale == 0) {
+      e[i] = d[i - 1];
+      for (int j = 0; j < i; ++j) {
+        d[j] = v[i - 1][j];
+        v[i][j] = 0;
+        v[j][i] = 0;
+      }
+    } else {
+      for (int k = 0; k < i; ++k) {
+        d[k] /= scale;
+        h += d[k] * d[k];
+      }
+      double f = d[i - 1];
+      double g = f > 0 ? -std::sqrt(h) : std::sqrt(h);
+      e[i] = scale * g;
+      h -= f * g;
+      d[i - 1] = f - g;
+      for (int j = 0; j < i; ++j) v[j][i] = d[j];
+      const std::size_t rows = i;
+      const std::size_t stride = n;
+      double *a = v.Data();
+      std::size_t grain = std::max(kGrainRows, kParallelWork / rows);
+      // e = A * d / h over the leading i x i block, A kept below the
+      // diagonal: row j of A is row j of v up to the diagonal, then
+      // column j of v.
+      S21Parallel::For(0, rows, grain, [&](std::size_t first,
+                                           std::size_t last) {
+        for (std::size_t j = first; j < last; ++j) {
+          const double *row = a + j * stride;
+          double sum = 0;
+          for (std::size_t k = 0; k <= j; ++k) sum += row[k] * d[k];
+          for (std::size_t k = j + 1; k < rows; ++k) {
+            sum += a[k * stride + j] * d[k];
+          }
+          e[j] = sum / h;
+        }
+      });
+      f = 0;
+      for (int j = 0; j < i; ++j) f += e[j] * d[j];
+      double hh = f / (h + h);
+      for (int j = 0; j < i; ++j) e[j] -= hh * d[j];
+      // A -= d * e^T + e * d^T.
+      S21Parallel::For(0, rows, grain, [&](std::size_t first,
+                                           std::size_t last) {
+        for (std::size_t k = first; k < last; ++k) {
+          double *row = a + k * stride;
+          double dk = d[k], ek = e[k];
+          for (std::size_t j = 0; j <= k; ++j) {
+            row[j] -= d[j] * ek + e[j] * dk;
+          }
+        }
+      });
+      for (int j = 0; j < i; ++j) {
+        d[j] = v[i - 1][j];
+        v[i][j] = 0;
+      }
+    }
+    d[i] = h;
+  }
+  // Accumulate the transformations; columns j <= i are independent.
+  for (int i = 0; i < n - 1; ++i) {
+    v[n - 1][i] = v[i][i];
+    v[i][i] = 1;
+    double h = d[i + 1];
+    if (h != 0) {
+      for (int k = 0; k <= i; ++k) d[k] = v[k][i + 1] / h;
+      const std::size_t stride = n;
+      double *a = v.Data();
+      S21Parallel::For(0, i + 1, kGrainRows, [&](std::size_t first,
+                                                 std::size_t last) {
+        for (std::size_t j = first; j < last; ++j) {
+          double g = 0;
+          for (int k = 0; k <= i; ++k) {
+            g += a[k * stride + i + 1] * a[k * stride + j];
+          }
+          for (int k = 0; k <= i; ++k) a[k * stride + j] -= g * d[k];
+        }
+      });
+    }
+    for (int k = 0; k <= i; ++k) v[k][i + 1] = 0;
+  }
+  for (int j = 0; j < n; ++j) {
+    d[j] = v[n - 1][j];
+    v[n - 1][j] = 0;
+  }
+  v[n - 1][n - 1] = 1;
+  e[0] = 0;
+}
+
+// Applies the rotations of one QL sweep to every row of v. Rows are
+// independent, so the O(n) rotations x O(n) rows run in parallel.
+void ApplyRotations(const std::vector<Rotation> &rotations, S21Matrix &v) {
+  S21Parallel::For(0, v.GetRows(), kGrainRows, [&](std::size_t first,
+                                                   std::size_t last) {
+    for (std::size_t k = first; k < last; ++k) {
+      double *row = v[k];
+      for (const Rotation &r : rotations) {
+        double h = row[r.col + 1];
+        row[r.col + 1] = r.s * row[r.col] + r.c * h;
+        row[r.col] = r.c * row[r.col] - r.s * h;
+      }
+    }
+  });
+}
+
+// Implicit QL iteration on the tridiagonal (d, e) (EISPACK tql2), applying
+// the rotations to v. Returns false if an eigenvalue fails to converge.
+bool TridiagonalQl(std::vector<double> &d, std::vector<double> &e,
+                   S21Matrix &v) {
+  int n = static_cast<int>(d.size());
+  for (int i = 1; i < n; ++i) e[i - 1] = e[i];
+  e[n - 1] = 0;
+  double f = 0, tst1 = 0;
+  std::vector<Rotation> rotations;
+  for (int l = 0; l < n; ++l) {
+    tst1 = std::max(tst1, std::abs(d[l]) + std::abs(e[l]));
+    int m = l;
+    while (m < n - 1 && std::abs(e[m]) > DBL_EPSILON * tst1) ++m;
+    int iteration = 0;
+    while (m > l && std::abs(e[l]) > DBL_EPSILON * tst1) {
+      if (++iteration > 30 * n) return false;
+      double g = d[l];
+      double p = (d[l + 1] - g) / (2 * e[l]);
+      double r = std::hypot(p, 1.0);
+      if (p < 0) r = -r;
+      d[l] = e[l] / (p + r);
+      d[l + 1] = e[l] * (p + r);
+      double dl1 = d[l + 1];
+      double h = g - d[l];
+      for (int i = l + 2; i < n; ++i) d[i] -= h;
+      f += h;
+      p = d[m];
+      double c = 1, c2 = 1, c3 = 1, s = 0, s2 = 0;
+      double el1 = e[l + 1];
+      rotations.clear();
+      for (int i = m - 1; i >= l; --i) {
+        c3 = c2;
+        c2 = c;
+        s2 = s;
+        g = c * e[i];
+        h = c * p;
+        r = std::hypot(p, e[i]);
+        e[i + 1] = s * r;
+        s = e[i] / r;
+        c = p / r;
+        p = c * d[i] - s * g;
+        d[i + 1] = h + s * (c * g + s * d[i]);
+        rotations.push_back({i, c, s});
+      }
+      ApplyRotations(rotations, v);
+      p = -s * s2 * c3 * el1 * e[l] / dl1;
+      e[l] = s * p;
+      d[l] = c * p;
+    }
+    d[l] += f;
+    e[l] = 0;
+  }
+  return true;
+}
+
+// Returns the columns of 'vectors' listed in order, with their values.
+S21EigenResult SelectPairs(const std::vector<double> &values,
+                           const S21Matrix &vectors,
+                           const std::vector<int> &order) {
+  int n = vectors.GetRows();
+  S21EigenResult result{{}, S21Matrix(n, static_cast<int>(order.size()))};
+  for (std::size_t c = 0; c < order.size(); ++c) {
+    result.values.push_back(values[order[c]]);
+    for (int i = 0; i < n; ++i) result.vectors[i][c] = vectors[i][order[c]];
+  }
+  return result;
+}
+
+S21EigenResult DenseSymmetricEigen(const S21Matrix &a) {
+  S21Matrix v(a);
+  std::vector<double> d, e;
+  Tridiagonalize(v, d, e);
+  if (!TridiagonalQl(d, e, v)) {
+    S21Throw(S21Status::kNotConverged,
+             "Eigenvalue iteration did not converge.");
+  }
+  std::vector<int> order(d.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&d](int x, int y) { return d[x] > d[y]; });
+  return SelectPairs(d, v, order);
+}
+
+// Orthonormalizes the rows of q in place by modified Gram-Schmidt, run
+// twice for stability. Rows that are numerically dependent become zero.
+void OrthonormalizeRows(S21Matrix &q) {
+  int rows = q.GetRows(), cols = q.GetCols();
+  for (int pass = 0; pass < 2; ++pass) {
+    for (int i = 0; i < rows; ++i) {
+      double *qi = q[i];
+      for (int k = 0; k < i; ++k) {
+        const double *qk = q[k];
+        double dot = 0;
+        for (int j = 0; j < cols; ++j) dot += qi[j] * qk[j];
+        for (int j = 0; j < cols; ++j) qi[j] -= dot * qk[j];
+      }
+      double norm = 0;
+      for (int j = 0; j < cols; ++j) norm += qi[j] * qi[j];
+      norm = std::sqrt(norm);
+      double scale = norm > DBL_EPSILON ? 1 / norm : 0;
+      for (int j = 0; j < cols; ++j) qi[j] *= scale;
+    }
+  }
+}
+
+// Orthonormal basis of the column space of y, as a matrix of columns.
+S21Matrix Orthonormalize(const S21Matrix &y) {
+  S21Matrix rows = y.Transpose();
+  OrthonormalizeRows(rows);
+  return rows.Transpose();
+}
+
+// One-sided Jacobi on the rows of 'a' (the columns of the original
+// matrix), accumulating the same rotations into the rows of 'v'. A round
+// robin schedule pairs every column with every other once per sweep in
+// rounds of disjoint pairs, which are rotated in parallel.
+void JacobiRows(S21Matrix &a, S21Matrix &v) {
+  int n = a.GetRows(), m = a.GetCols();
+  int players = n + (n % 2);
+  std::vector<int> ring(players);
+  std::iota(ring.begin(), ring.end(), 0);
+  const double kTolerance = 2 * DBL_EPSILON;
+  for (int sweep = 0; sweep < kMaxSweeps; ++sweep) {
+    std::atomic<bool> rotated{false};
+    for (int round = 0; round < players - 1; ++round) {
+      S21Parallel::For(0, players / 2, 4, [&](std::size_t first,
+                                              std::size_t last) {
+        for (std::size_t pair = first; pair < last; ++pair) {
+          int p = ring[pair], q = ring[players - 1 - pair];
+          if (p >= n || q >= n) continue;
+          double *ap = a[p], *aq = a[q];
+          double alpha = 0, beta = 0, gamma = 0;
+          for (int k = 0; k < m; ++k) {
+            alpha += ap[k] * ap[k];
+            beta += aq[k] * aq[k];
+            gamma += ap[k] * aq[k];
+          }
+          if (std::abs(gamma) <= kTolerance * std::sqrt(alpha * beta)) {
+            continue;
+          }
+          rotated = true;
+          double zeta = (beta - alpha) / (2 * gamma);
+          double t = (zeta >= 0 ? 1.0 : -1.0) /
+                     (std::abs(zeta) + std::sqrt(1 + zeta * zeta));
+          double c = 1 / std::sqrt(1 + t * t), s = c * t;
+          for (int k = 0; k < m; ++k) {
+            double x = ap[k], y = aq[k];
+            ap[k] = c * x - s * y;
+            aq[k] = s * x + c * y;
+          }
+          double *vp = v[p], *vq = v[q];
+          for (int k = 0; k < n; ++k) {
+            double x = vp[k], y = vq[k];
+            vp[k] = c * x - s * y;
+            vq[k] = s * x + c * y;
+          }
+        }
+      });
+      std::rotate(ring.begin() + 1, ring.end() - 1, ring.end());
+    }
+    if (!rotated) return;
+  }
+  S21Throw(S21Status::kNotConverged,
+           "Singular value iteration did not converge.");
+}
+
+// Thin SVD of a with rows >= cols.
+S21SvdResult TallSvd(const S21Matrix &a) {
+  int m = a.GetRows(), n = a.GetCols();
+  S21Matrix columns = a.Transpose();
+  S21Matrix v_rows(n, n);
+  for (int i = 0; i < n; ++i) v_rows[i][i] = 1;
+  JacobiRows(columns, v_rows);
+  std::vector<double> norms(n);
+  for (int i = 0; i < n; ++i) {
+    double sum = 0;
+    for (double value : columns.Row(i)) sum += value * value;
+    norms[i] = std::sqrt(sum);
+  }
+  std::vector<int> order(n);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&norms](int x, int y) { return norms[x] > norms[y]; });
+  S21SvdResult result{S21Matrix(m, n), {}, S21Matrix(n, n)};
+  for (int c = 0; c < n; ++c) {
+    int source = order[c];
+    double sigma = norms[source];
+    result.singular_values.push_back(sigma);
+    double scale = sigma > 0 ? 1 / sigma : 0;
+    for (int i = 0; i < m; ++i) result.u[i][c] = columns[source][i] * scale;
+    for (int i = 0; i < n; ++i) result.v[i][c] = v_rows[source][i];
+  }
+  return result;
+}
+
+S21SvdResult DenseSvd(const S21Matrix &a) {
+  if (a.GetRows() >= a.GetCols()) return TallSvd(a);
+  S21SvdResult transposed = TallSvd(a.Transpose());
+  std::swap(transposed.u, transposed.v);
+  return transposed;
+}
+
+S21Matrix LeadingColumns(const S21Matrix &matrix, int count) {
+  S21Matrix result(matrix.GetRows(), count);
+  for (int i = 0; i < matrix.GetRows(); ++i) {
+    std::copy(matrix[i], matrix[i] + count, result[i]);
+  }
+  return result;
+}
+
+void CheckCount(int count, int limit) {
+  if (count < 1 || count > limit) {
+    S21Throw(S21Status::kInvalidSize,
+             "Error: count must be in [1, matrix size].");
+  }
+}
+
+void CheckSymmetric(const S21Matrix &a) {
+  if (a.GetRows() != a.GetCols()) {
+    S21Throw(S21Status::kNotSquare);
+  }
+  for (int i = 0; i < a.GetRows(); ++i) {
+    for (int j = 0; j < i; ++j) {
+      if (std::abs(a[i][j] - a[j][i]) >
+          kEps * std::max(1.0, std::abs(a[i][j]))) {
+        S21Throw(S21Status::kInvalidMatrix, "The matrix is not symmetric.");
+      }
+    }
+  }
+}
+
+}  // namespace
+
+S21EigenResult S21Matrix::SymmetricEigen() const {
+  CheckSymmetric(*this);
+  return DenseSymmetricEigen(*this);
+}
+
+// Randomized subspace iteration: project onto an orthonormal basis Q of
+// A^(q+1) * Omega, solve the small problem Q^T A Q exactly, and keep the
+// pairs with the largest |eigenvalue|.
+S21EigenResult S21Matrix::SymmetricEigen(int count, std::uint64_t seed) const {
+  CheckSymmetric(*this);
+  CheckCount(count, rows_);
+  int samples = std::min(rows_, count + kOversampling);
+  S21Matrix q(rows_, samples);
+  q.NormalFillMatrix(0, 1, seed);
+  for (int i = 0; i <= kPowerIterations; ++i) q = Orthonormalize(*this * q);
+  S21Matrix small = q.Transpose() * (*this * q);
+  small = (small + small.Transpose()) * 0.5;
+  S21EigenResult projected = DenseSymmetricEigen(small);
+  std::vector<int> order(samples);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&projected](int x, int y) {
+    return std::abs(projected.values[x]) > std::abs(projected.values[y]);
+  });
+  order.resize(count);
+  S21EigenResult top = SelectPairs(projected.values, projected.vectors, order);
+  top.vectors = q * top.vectors;
+  return top;
+}
+
+S21SvdResult S21Matrix::Svd() const { return DenseSvd(*this); }
+
+// Randomized range finder with power iterations, followed by an exact SVD
+// of the small projected matrix Q^T A.
+S21SvdResult S21Matrix::Svd(int count, std::uint64_t seed) const {
+  CheckCount(count, std::min(rows_, cols_));
+  int samples = std::min(std::min(rows_, cols_), count + kOversampling);
+  S21Matrix omega(cols_, samples);
+  omega.NormalFillMatrix(0, 1, seed);
+  S21Matrix transposed = Transpose();
+  S21Matrix q = Orthonormalize(*this * omega);
+  for (int i = 0; i < kPowerIterations; ++i) {
+    q = Orthonormalize(*this * Orthonormalize(transposed * q));
+  }
+  S21SvdResult small = DenseSvd(q.Transpose() * *this);
+  S21SvdResult result{LeadingColumns(q * small.u, count),
+                      std::vector<double>(small.singular_values.begin(),
+                                          small.singular_values.begin() +
+                                              count),
+                      LeadingColumns(small.v, count)};
+  return result;
+}
+
+S21EigenResult S21SymmetricMatrix::Eigen() const {
+  return DenseSymmetricEigen(ToMatrix());
+}
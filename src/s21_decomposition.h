@@ -0,0 +1,23 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_DECOMPOSITION_H
+#define CPP1_S21_MATRIXPLUS_S21_DECOMPOSITION_H
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// A = V * diag(values) * V^T for a symmetric A. Eigenvectors are the
+// columns of 'vectors', in the same order as 'values'.
+struct S21EigenResult {
+  std::vector<double> values;
+  S21Matrix vectors;
+};
+
+// Thin SVD A = U * diag(singular_values) * V^T with U m x r and V n x r,
+// singular values in descending order.
+struct S21SvdResult {
+  S21Matrix u;
+  std::vector<double> singular_values;
+  S21Matrix v;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_DECOMPOSITION_H
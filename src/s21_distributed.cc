@@ -0,0 +1,650 @@
+#include "s21_distributed.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "s21_parallel.h"
+#include "s21_status.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+// Panels of the shared dimension are at most this wide, so the broadcast of
+// the next panel overlaps with the product of the current one.
+const int kPanelWidth = 256;
+
+// Broadcast panels a rank may hold ahead of its local products.
+const std::size_t kPipelineDepth = 2;
+
+// A waiting shared memory rank spins, then yields, then sleeps.
+const int kSpinRounds = 128;
+const int kYieldRounds = 4096;
+
+// How often rank 0 checks on the worker processes.
+const std::chrono::milliseconds kReapInterval(5);
+
+// Leading bytes of a shared memory segment, holding the abort flag.
+const std::size_t kHeaderBytes = 64;
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free &&
+                  std::atomic<int>::is_always_lock_free,
+              "Shared memory channels need address-free atomics.");
+
+std::atomic<unsigned> segment_count{0};
+
+[[noreturn]] void Fail(const char *message) {
+  S21Throw(S21Status::kTransportFailed, message);
+}
+
+// Polling interval of blocked TCP calls, bounding how long they take to
+// notice an Abort().
+const int kPollMilliseconds = 100;
+
+void CloseAll(std::vector<int> &fds) {
+  for (int &fd : fds) {
+    if (fd >= 0) close(fd);
+    fd = -1;
+  }
+}
+
+sockaddr_in Loopback(int port) {
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(static_cast<std::uint16_t>(port));
+  return address;
+}
+
+}  // namespace
+
+// S21SharedMemoryTransport
+
+struct S21SharedMemoryTransport::Channel {
+  alignas(64) std::atomic<std::uint64_t> written;  // Doubles ever sent
+  alignas(64) std::atomic<std::uint64_t> read;     // Doubles ever received
+};
+
+S21SharedMemoryTransport::S21SharedMemoryTransport(std::size_t channel_bytes)
+    : capacity_(std::max<std::size_t>(channel_bytes / sizeof(double), 64)) {
+  capacity_ = (capacity_ + 7) / 8 * 8;  // Keeps every channel line-aligned
+}
+
+S21SharedMemoryTransport::~S21SharedMemoryTransport() { Close(); }
+
+void S21SharedMemoryTransport::Open(int size) {
+  Close();
+  std::string name = "/s21_matrix_" + std::to_string(getpid()) + "_" +
+                     std::to_string(segment_count++);
+  stride_ = sizeof(Channel) + capacity_ * sizeof(double);
+  std::size_t bytes = kHeaderBytes + stride_ * size * size;
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) Fail("Cannot create a shared memory segment.");
+  void *segment = MAP_FAILED;
+  if (ftruncate(fd, static_cast<off_t>(bytes)) == 0) {
+    segment = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  shm_unlink(name.c_str());
+  if (segment == MAP_FAILED) Fail("Cannot map a shared memory segment.");
+  segment_ = segment;
+  segment_bytes_ = bytes;
+  size_ = size;
+  new (segment_) std::atomic<int>(0);
+  for (int from = 0; from < size; ++from) {
+    for (int to = 0; to < size; ++to) new (&GetChannel(from, to)) Channel();
+  }
+}
+
+void S21SharedMemoryTransport::Attach(int rank) { rank_ = rank; }
+
+void S21SharedMemoryTransport::Send(int to, const double *data,
+                                    std::size_t count) {
+  Channel &channel = GetChannel(rank_, to);
+  double *ring = Ring(channel);
+  std::uint64_t head = channel.written.load(std::memory_order_relaxed);
+  while (count > 0) {
+    if (head >= capacity_) Wait(channel.read, head - capacity_ + 1);
+    std::uint64_t tail = channel.read.load(std::memory_order_acquire);
+    std::size_t offset = head % capacity_;
+    std::size_t chunk = std::min({count, capacity_ - (head - tail),
+                                  capacity_ - offset});
+    std::memcpy(ring + offset, data, chunk * sizeof(double));
+    data += chunk;
+    count -= chunk;
+    head += chunk;
+    channel.written.store(head, std::memory_order_release);
+  }
+}
+
+void S21SharedMemoryTransport::Receive(int from, double *data,
+                                       std::size_t count) {
+  Channel &channel = GetChannel(from, rank_);
+  const double *ring = Ring(channel);
+  std::uint64_t tail = channel.read.load(std::memory_order_relaxed);
+  while (count > 0) {
+    Wait(channel.written, tail + 1);
+    std::uint64_t head = channel.written.load(std::memory_order_acquire);
+    std::size_t offset = tail % capacity_;
+    std::size_t chunk = std::min({count, static_cast<std::size_t>(head - tail),
+                                  capacity_ - offset});
+    std::memcpy(data, ring + offset, chunk * sizeof(double));
+    data += chunk;
+    count -= chunk;
+    tail += chunk;
+    channel.read.store(tail, std::memory_order_release);
+  }
+}
+
+void S21SharedMemoryTransport::Abort() {
+  if (segment_) {
+    static_cast<std::atomic<int> *>(segment_)->store(1);
+  }
+}
+
+void S21SharedMemoryTransport::Close() {
+  if (segment_) munmap(segment_, segment_bytes_);
+  segment_ = nullptr;
+  segment_bytes_ = 0;
+  size_ = 0;
+}
+
+S21SharedMemoryTransport::Channel &S21SharedMemoryTransport::GetChannel(
+    int from, int to) const {
+  char *base = static_cast<char *>(segment_) + kHeaderBytes;
+  return *reinterpret_cast<Channel *>(
+      base + stride_ * (static_cast<std::size_t>(from) * size_ + to));
+}
+
+double *S21SharedMemoryTransport::Ring(Channel &channel) const {
+  return reinterpret_cast<double *>(reinterpret_cast<char *>(&channel) +
+                                    sizeof(Channel));
+}
+
+void S21SharedMemoryTransport::Wait(const std::atomic<std::uint64_t> &counter,
+                                    std::uint64_t value) const {
+  const auto &aborted = *static_cast<const std::atomic<int> *>(segment_);
+  for (int round = 0; counter.load(std::memory_order_acquire) < value;
+       ++round) {
+    if (aborted.load(std::memory_order_relaxed)) {
+      Fail("A peer process failed.");
+    }
+    if (round >= kYieldRounds) {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    } else if (round >= kSpinRounds) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+// S21TcpTransport
+
+S21TcpTransport::~S21TcpTransport() { Close(); }
+
+void S21TcpTransport::Open(int size) {
+  Close();
+  aborted_ = false;
+  listeners_.assign(size, -1);
+  ports_.assign(size, 0);
+  for (int rank = 0; rank < size; ++rank) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    listeners_[rank] = fd;
+    sockaddr_in address = Loopback(0);
+    socklen_t length = sizeof(address);
+    if (fd < 0 ||
+        bind(fd, reinterpret_cast<sockaddr *>(&address), length) != 0 ||
+        listen(fd, size) != 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr *>(&address), &length) !=
+            0) {
+      Close();
+      Fail("Cannot open a loopback socket.");
+    }
+    ports_[rank] = ntohs(address.sin_port);
+  }
+}
+
+void S21TcpTransport::Attach(int rank) {
+  int size = static_cast<int>(listeners_.size());
+  rank_ = rank;
+  for (int other = 0; other < size; ++other) {
+    if (other != rank && listeners_[other] >= 0) close(listeners_[other]);
+    if (other != rank) listeners_[other] = -1;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    peers_.assign(size, -1);
+  }
+  for (int lower = 0; lower < rank; ++lower) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) Fail("Cannot open a loopback socket.");
+    AddPeer(lower, fd);
+    sockaddr_in address = Loopback(ports_[lower]);
+    if (connect(fd, reinterpret_cast<sockaddr *>(&address),
+                sizeof(address)) != 0) {
+      Fail("Cannot connect to a peer process.");
+    }
+    WriteAll(fd, &rank, sizeof(rank));
+  }
+  for (int count = rank + 1; count < size; ++count) {
+    WaitFor(listeners_[rank], POLLIN);
+    int fd = accept(listeners_[rank], nullptr, nullptr);
+    if (fd < 0) Fail("Cannot accept a peer process.");
+    int peer = -1;
+    ReadAll(fd, &peer, sizeof(peer));
+    if (peer <= rank || peer >= size || peers_[peer] >= 0) {
+      close(fd);
+      Fail("Unexpected peer connection.");
+    }
+    AddPeer(peer, fd);
+  }
+  close(listeners_[rank]);
+  listeners_[rank] = -1;
+}
+
+void S21TcpTransport::AddPeer(int rank, int fd) {
+  int on = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+  std::lock_guard<std::mutex> lock(mutex_);
+  peers_[rank] = fd;
+}
+
+void S21TcpTransport::Send(int to, const double *data, std::size_t count) {
+  WriteAll(peers_[to], data, count * sizeof(double));
+}
+
+void S21TcpTransport::Receive(int from, double *data, std::size_t count) {
+  ReadAll(peers_[from], data, count * sizeof(double));
+}
+
+void S21TcpTransport::Abort() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  aborted_ = true;
+  for (int fd : peers_) {
+    if (fd >= 0) shutdown(fd, SHUT_RDWR);
+  }
+}
+
+void S21TcpTransport::Close() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  CloseAll(listeners_);
+  CloseAll(peers_);
+}
+
+void S21TcpTransport::WaitFor(int fd, short events) const {
+  pollfd entry = {fd, events, 0};
+  for (;;) {
+    if (aborted_) Fail("The distributed computation was aborted.");
+    int ready = poll(&entry, 1, kPollMilliseconds);
+    if (ready > 0) return;
+    if (ready < 0 && errno != EINTR) Fail("Cannot poll a peer connection.");
+  }
+}
+
+void S21TcpTransport::WriteAll(int fd, const void *data,
+                               std::size_t bytes) const {
+  const char *next = static_cast<const char *>(data);
+  while (bytes > 0) {
+    WaitFor(fd, POLLOUT);
+#ifdef MSG_NOSIGNAL
+    ssize_t written = send(fd, next, bytes, MSG_NOSIGNAL);
+#else
+    ssize_t written = write(fd, next, bytes);
+#endif
+    if (written < 0 && errno == EINTR) continue;
+    if (written <= 0) Fail("Cannot send to a peer process.");
+    next += written;
+    bytes -= static_cast<std::size_t>(written);
+  }
+}
+
+void S21TcpTransport::ReadAll(int fd, void *data, std::size_t bytes) const {
+  char *next = static_cast<char *>(data);
+  while (bytes > 0) {
+    WaitFor(fd, POLLIN);
+    ssize_t read = recv(fd, next, bytes, 0);
+    if (read < 0 && errno == EINTR) continue;
+    if (read <= 0) Fail("A peer process closed its connection.");
+    next += read;
+    bytes -= static_cast<std::size_t>(read);
+  }
+}
+
+// Distributed product
+
+namespace {
+
+// Shared-dimension columns [first, first + width), all held by one grid
+// column of a and one grid row of b.
+struct Panel {
+  int first;
+  int width;
+  int a_owner;  // Grid column holding the panel of a
+  int b_owner;  // Grid row holding the panel of b
+};
+
+std::vector<int> Bounds(int total, int parts) {
+  std::vector<int> bounds(parts + 1);
+  for (int i = 0; i <= parts; ++i) {
+    bounds[i] = static_cast<int>(static_cast<long long>(total) * i / parts);
+  }
+  return bounds;
+}
+
+int Owner(const std::vector<int> &bounds, int index) {
+  return static_cast<int>(
+      std::upper_bound(bounds.begin(), bounds.end(), index) - bounds.begin() -
+      1);
+}
+
+// Process grid of a (m x k) * b (k x n). Rank r sits at grid row r / cols
+// and column r % cols and holds the blocks of a, b and the product at that
+// position. The columns of a are split over the grid columns and the rows
+// of b over the grid rows, so the panels follow the union of both splits.
+struct Grid {
+  Grid(int m, int k, int n, int processes) {
+    int short_side = 1;
+    for (int d = 1; d * d <= processes; ++d) {
+      if (processes % d == 0) short_side = d;
+    }
+    int long_side = processes / short_side;
+    rows = m >= n ? long_side : short_side;
+    cols = m >= n ? short_side : long_side;
+    rows = std::min({rows, m, k});
+    cols = std::min({cols, n, k});
+    m_bounds = Bounds(m, rows);
+    n_bounds = Bounds(n, cols);
+    a_bounds = Bounds(k, cols);
+    b_bounds = Bounds(k, rows);
+    std::vector<int> cuts = a_bounds;
+    cuts.insert(cuts.end(), b_bounds.begin(), b_bounds.end());
+    std::sort(cuts.begin(), cuts.end());
+    cuts.erase(std::unique(cuts.begin(), cuts.end()), cuts.end());
+    for (std::size_t c = 0; c + 1 < cuts.size(); ++c) {
+      int length = cuts[c + 1] - cuts[c];
+      int count = (length + kPanelWidth - 1) / kPanelWidth;
+      for (int p = 0; p < count; ++p) {
+        int first = cuts[c] + length * p / count;
+        int last = cuts[c] + length * (p + 1) / count;
+        panels.push_back({first, last - first, Owner(a_bounds, first),
+                          Owner(b_bounds, first)});
+      }
+    }
+  }
+
+  int Size() const { return rows * cols; }
+  int Rows(int row) const { return m_bounds[row + 1] - m_bounds[row]; }
+  int Cols(int col) const { return n_bounds[col + 1] - n_bounds[col]; }
+  int ACols(int col) const { return a_bounds[col + 1] - a_bounds[col]; }
+  int BRows(int row) const { return b_bounds[row + 1] - b_bounds[row]; }
+
+  int rows;
+  int cols;
+  std::vector<int> m_bounds;
+  std::vector<int> n_bounds;
+  std::vector<int> a_bounds;
+  std::vector<int> b_bounds;
+  std::vector<Panel> panels;
+};
+
+S21Matrix Block(const S21Matrix &matrix, int row, int col, int rows,
+                int cols) {
+  S21Matrix block(rows, cols);
+  const double *source = matrix.Data();
+  double *target = block.Data();
+  for (int i = 0; i < rows; ++i) {
+    const double *from =
+        source + static_cast<std::size_t>(row + i) * matrix.GetCols() + col;
+    std::copy(from, from + cols, target + static_cast<std::size_t>(i) * cols);
+  }
+  return block;
+}
+
+void SendMatrix(S21Transport &transport, int to, const S21Matrix &matrix) {
+  transport.Send(to, matrix.Data(),
+                 static_cast<std::size_t>(matrix.GetRows()) *
+                     matrix.GetCols());
+}
+
+void ReceiveMatrix(S21Transport &transport, int from, S21Matrix &matrix) {
+  transport.Receive(from, matrix.Data(),
+                    static_cast<std::size_t>(matrix.GetRows()) *
+                        matrix.GetCols());
+  matrix.MarkModified();
+}
+
+// SUMMA on one rank: the owners broadcast each panel of a along their grid
+// row and each panel of b along their grid column, and every rank adds the
+// product of the two panels to its block. A second thread broadcasts up to
+// kPipelineDepth panels ahead, so communication overlaps the products.
+S21Matrix Summa(int rank, const Grid &grid, const S21Matrix &a_block,
+                const S21Matrix &b_block, S21Transport &transport) {
+  int row = rank / grid.cols;
+  int col = rank % grid.cols;
+  using PanelPair = std::pair<S21Matrix, S21Matrix>;
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<PanelPair> ready;
+  std::exception_ptr error;
+  bool stopping = false;
+
+  auto broadcast = [&](const Panel &panel) {
+    S21Matrix a_panel(grid.Rows(row), panel.width);
+    S21Matrix b_panel(panel.width, grid.Cols(col));
+    int a_root = row * grid.cols + panel.a_owner;
+    if (rank == a_root) {
+      a_panel = Block(a_block, 0, panel.first - grid.a_bounds[col],
+                      grid.Rows(row), panel.width);
+      for (int peer = 0; peer < grid.cols; ++peer) {
+        if (peer != col) SendMatrix(transport, row * grid.cols + peer, a_panel);
+      }
+    } else {
+      ReceiveMatrix(transport, a_root, a_panel);
+    }
+    int b_root = panel.b_owner * grid.cols + col;
+    if (rank == b_root) {
+      b_panel = Block(b_block, panel.first - grid.b_bounds[row], 0,
+                      panel.width, grid.Cols(col));
+      for (int peer = 0; peer < grid.rows; ++peer) {
+        if (peer != row) SendMatrix(transport, peer * grid.cols + col, b_panel);
+      }
+    } else {
+      ReceiveMatrix(transport, b_root, b_panel);
+    }
+    return PanelPair(std::move(a_panel), std::move(b_panel));
+  };
+
+  std::thread communication([&] {
+    S21_TRY {
+      for (const Panel &panel : grid.panels) {
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          changed.wait(lock, [&] {
+            return stopping || ready.size() < kPipelineDepth;
+          });
+          if (stopping) return;
+        }
+        PanelPair pair = broadcast(panel);
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.push_back(std::move(pair));
+        changed.notify_all();
+      }
+    }
+    S21_CATCH_ALL {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!error) error = std::current_exception();
+      changed.notify_all();
+    }
+  });
+
+  S21Matrix c(grid.Rows(row), grid.Cols(col));
+  S21_TRY {
+    for (std::size_t step = 0; step < grid.panels.size(); ++step) {
+      std::optional<PanelPair> pair;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return error || !ready.empty(); });
+        if (ready.empty()) break;
+        pair.emplace(std::move(ready.front()));
+        ready.pop_front();
+        changed.notify_all();
+      }
+      c += pair->first * pair->second;
+    }
+  }
+  S21_CATCH_ALL {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!error) error = std::current_exception();
+    stopping = true;
+    changed.notify_all();
+    transport.Abort();
+  }
+  communication.join();
+  if (error) std::rethrow_exception(error);
+  return c;
+}
+
+// Worker ranks receive their blocks from rank 0, which keeps its own and
+// later gathers the product blocks.
+[[noreturn]] void RunWorker(int rank, const Grid &grid,
+                            S21Transport &transport) {
+  int status = 0;
+  S21_TRY {
+    S21Parallel::SetNumThreads(
+        std::max(1, S21Parallel::GetNumThreads() / grid.Size()));
+    transport.Attach(rank);
+    int row = rank / grid.cols;
+    int col = rank % grid.cols;
+    S21Matrix a_block(grid.Rows(row), grid.ACols(col));
+    S21Matrix b_block(grid.BRows(row), grid.Cols(col));
+    ReceiveMatrix(transport, 0, a_block);
+    ReceiveMatrix(transport, 0, b_block);
+    SendMatrix(transport, 0, Summa(rank, grid, a_block, b_block, transport));
+    transport.Close();
+  }
+  S21_CATCH_ALL {
+    transport.Abort();
+    status = 1;
+  }
+  _exit(status);
+}
+
+S21Matrix RunRoot(const S21Matrix &a, const S21Matrix &b, const Grid &grid,
+                  S21Transport &transport) {
+  transport.Attach(0);
+  for (int rank = 1; rank < grid.Size(); ++rank) {
+    int row = rank / grid.cols;
+    int col = rank % grid.cols;
+    SendMatrix(transport, rank,
+               Block(a, grid.m_bounds[row], grid.a_bounds[col],
+                     grid.Rows(row), grid.ACols(col)));
+    SendMatrix(transport, rank,
+               Block(b, grid.b_bounds[row], grid.n_bounds[col],
+                     grid.BRows(row), grid.Cols(col)));
+  }
+  S21Matrix a_block = Block(a, 0, 0, grid.Rows(0), grid.ACols(0));
+  S21Matrix b_block = Block(b, 0, 0, grid.BRows(0), grid.Cols(0));
+  S21Matrix result(a.GetRows(), b.GetCols());
+  S21Matrix c = Summa(0, grid, a_block, b_block, transport);
+  for (int rank = 0; rank < grid.Size(); ++rank) {
+    int row = rank / grid.cols;
+    int col = rank % grid.cols;
+    if (rank > 0) {
+      c = S21Matrix(grid.Rows(row), grid.Cols(col));
+      ReceiveMatrix(transport, rank, c);
+    }
+    double *target = result.Data();
+    for (int i = 0; i < c.GetRows(); ++i) {
+      const double *from = c.Data() + static_cast<std::size_t>(i) * c.GetCols();
+      std::copy(from, from + c.GetCols(),
+                target +
+                    static_cast<std::size_t>(grid.m_bounds[row] + i) *
+                        result.GetCols() +
+                    grid.n_bounds[col]);
+    }
+  }
+  return result;
+}
+
+// Waits for every worker, in whatever order they end; false when one of
+// them failed, in which case the transport is aborted at once so that no
+// rank waits on it forever.
+bool Reap(std::vector<pid_t> workers, S21Transport &transport) {
+  bool succeeded = true;
+  while (!workers.empty()) {
+    bool reaped = false;
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+      int status = 0;
+      pid_t pid = waitpid(workers[i], &status, WNOHANG);
+      if (pid == 0 || (pid < 0 && errno == EINTR)) continue;
+      if (pid < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        if (succeeded) transport.Abort();
+        succeeded = false;
+      }
+      workers.erase(workers.begin() + i--);
+      reaped = true;
+    }
+    if (!reaped) std::this_thread::sleep_for(kReapInterval);
+  }
+  return succeeded;
+}
+
+}  // namespace
+
+void S21Matrix::MulMatrixDistributed(const S21Matrix &other,
+                                     S21Transport &transport, int processes) {
+  if (cols_ != other.rows_) S21Throw(S21Status::kProductMismatch);
+  if (processes < 1) {
+    S21Throw(S21Status::kInvalidArgument,
+             "The number of processes must be positive.");
+  }
+  Grid grid(rows_, cols_, other.cols_, processes);
+  transport.Open(grid.Size());
+  std::vector<pid_t> workers;
+  for (int rank = 1; rank < grid.Size(); ++rank) {
+    pid_t pid = fork();
+    if (pid == 0) RunWorker(rank, grid, transport);
+    if (pid < 0) {
+      transport.Abort();
+      Reap(workers, transport);
+      transport.Close();
+      Fail("Cannot start a worker process.");
+    }
+    workers.push_back(pid);
+  }
+  // Reaped while rank 0 works, so a worker that dies, even from a signal,
+  // aborts the computation instead of leaving its peers blocked.
+  bool workers_succeeded = true;
+  std::thread reaper(
+      [&] { workers_succeeded = Reap(workers, transport); });
+  std::optional<S21Matrix> result;
+  std::exception_ptr error;
+  S21_TRY { result.emplace(RunRoot(*this, other, grid, transport)); }
+  S21_CATCH_ALL {
+    error = std::current_exception();
+    transport.Abort();
+  }
+  reaper.join();
+  transport.Close();
+  if (error) std::rethrow_exception(error);
+  if (!workers_succeeded) Fail("A worker process failed.");
+  *this = std::move(*result);
+}
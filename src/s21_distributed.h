@@ -0,0 +1,99 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_DISTRIBUTED_H
+#define CPP1_S21_MATRIXPLUS_S21_DISTRIBUTED_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Point-to-point channels between the ranks of one distributed product,
+// rank 0 being the calling process. Open() runs once before the worker
+// processes are forked, then every process calls Attach() with its rank.
+// Send and Receive block; messages from one rank to another arrive in the
+// order they were sent, and a rank only talks to one peer at a time.
+class S21Transport {
+ public:
+  virtual ~S21Transport() = default;
+
+  virtual void Open(int size) = 0;
+  virtual void Attach(int rank) = 0;
+  virtual void Send(int to, const double *data, std::size_t count) = 0;
+  virtual void Receive(int from, double *data, std::size_t count) = 0;
+  // Makes the blocked and later calls of this process fail, and those of
+  // its peers as soon as the transport can tell them. Safe to call from
+  // another thread while one is blocked in Send or Receive.
+  virtual void Abort() = 0;
+  // Releases the channels of the calling process.
+  virtual void Close() = 0;
+};
+
+// One single-producer ring per ordered pair of ranks in a POSIX shared
+// memory segment, unlinked as soon as it is mapped, so nothing outlives
+// the processes. Waiting sides spin briefly, then yield.
+class S21SharedMemoryTransport : public S21Transport {
+ public:
+  explicit S21SharedMemoryTransport(std::size_t channel_bytes = 1 << 17);
+  ~S21SharedMemoryTransport() override;
+  S21SharedMemoryTransport(const S21SharedMemoryTransport &) = delete;
+  S21SharedMemoryTransport &operator=(const S21SharedMemoryTransport &) =
+      delete;
+
+  void Open(int size) override;
+  void Attach(int rank) override;
+  void Send(int to, const double *data, std::size_t count) override;
+  void Receive(int from, double *data, std::size_t count) override;
+  void Abort() override;
+  void Close() override;
+
+ private:
+  struct Channel;
+
+  Channel &GetChannel(int from, int to) const;
+  double *Ring(Channel &channel) const;
+  void Wait(const std::atomic<std::uint64_t> &counter,
+            std::uint64_t value) const;
+
+  std::size_t capacity_;  // Doubles per ring
+  std::size_t stride_ = 0;
+  int size_ = 0;
+  int rank_ = 0;
+  void *segment_ = nullptr;
+  std::size_t segment_bytes_ = 0;
+};
+
+// Fully connected TCP sockets on the loopback interface. Open() binds one
+// listening socket per rank to an ephemeral port; after the fork each rank
+// connects to the lower ranks and accepts the higher ones. Blocked calls
+// poll, so Abort() reaches them; peers see the sockets close.
+class S21TcpTransport : public S21Transport {
+ public:
+  S21TcpTransport() = default;
+  ~S21TcpTransport() override;
+  S21TcpTransport(const S21TcpTransport &) = delete;
+  S21TcpTransport &operator=(const S21TcpTransport &) = delete;
+
+  void Open(int size) override;
+  void Attach(int rank) override;
+  void Send(int to, const double *data, std::size_t count) override;
+  void Receive(int from, double *data, std::size_t count) override;
+  void Abort() override;
+  void Close() override;
+
+ private:
+  void AddPeer(int rank, int fd);
+  void WaitFor(int fd, short events) const;
+  void WriteAll(int fd, const void *data, std::size_t bytes) const;
+  void ReadAll(int fd, void *data, std::size_t bytes) const;
+
+  std::atomic<bool> aborted_{false};
+  std::mutex mutex_;  // Guards the sockets against Abort() from elsewhere
+  std::vector<int> listeners_;
+  std::vector<int> ports_;
+  std::vector<int> peers_;  // Socket per rank, -1 for the own rank
+  int rank_ = 0;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_DISTRIBUTED_H
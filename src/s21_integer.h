@@ -0,0 +1,456 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_INTEGER_H
+#define CPP1_S21_MATRIXPLUS_S21_INTEGER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_parallel.h"
+#include "s21_status.h"
+
+// Element of the prime field Z/PZ, kept reduced in [0, P). P below 2^31
+// keeps the sum of two elements in 32 bits and a product in 62 bits.
+template <std::uint32_t P>
+class S21ModInt {
+ public:
+  static constexpr bool IsPrime(std::uint32_t n) {
+    if (n < 2) return false;
+    for (std::uint32_t d = 2; d <= n / d; ++d) {
+      if (n % d == 0) return false;
+    }
+    return true;
+  }
+  static_assert(P < (1u << 31) && IsPrime(P), "P must be a prime below 2^31");
+  static constexpr std::uint32_t kModulus = P;
+
+  S21ModInt() = default;
+  // Implicit, so integer literals mix with field elements.
+  S21ModInt(std::int64_t value)
+      : value_(static_cast<std::uint32_t>((value % std::int64_t(P) + P) % P)) {
+  }
+
+  std::uint32_t Value() const { return value_; }
+
+  S21ModInt operator+(S21ModInt other) const {
+    std::uint32_t sum = value_ + other.value_;
+    return Reduced(sum >= P ? sum - P : sum);
+  }
+  S21ModInt operator-(S21ModInt other) const {
+    return Reduced(value_ >= other.value_ ? value_ - other.value_
+                                          : value_ + P - other.value_);
+  }
+  S21ModInt operator-() const { return Reduced(value_ ? P - value_ : 0); }
+  S21ModInt operator*(S21ModInt other) const {
+    return Reduced(static_cast<std::uint32_t>(
+        static_cast<std::uint64_t>(value_) * other.value_ % P));
+  }
+  S21ModInt &operator+=(S21ModInt other) { return *this = *this + other; }
+  S21ModInt &operator-=(S21ModInt other) { return *this = *this - other; }
+  S21ModInt &operator*=(S21ModInt other) { return *this = *this * other; }
+  bool operator==(S21ModInt other) const { return value_ == other.value_; }
+  bool operator!=(S21ModInt other) const { return value_ != other.value_; }
+
+  S21ModInt Pow(std::uint64_t power) const {
+    S21ModInt result = 1;
+    for (S21ModInt base = *this; power; power >>= 1, base *= base) {
+      if (power & 1) result *= base;
+    }
+    return result;
+  }
+  // Fermat's little theorem: a^(P - 2) * a = 1.
+  S21ModInt Inverse() const {
+    if (value_ == 0) {
+      S21Throw(S21Status::kInvalidArgument, "Zero has no modular inverse.");
+    }
+    return Pow(P - 2);
+  }
+
+ private:
+  static S21ModInt Reduced(std::uint32_t value) {
+    S21ModInt result;
+    result.value_ = value;
+    return result;
+  }
+
+  std::uint32_t value_ = 0;
+};
+
+template <typename T>
+struct S21IsModInt : std::false_type {};
+template <std::uint32_t P>
+struct S21IsModInt<S21ModInt<P>> : std::true_type {};
+
+// Exact dense matrix over T = std::int64_t or S21ModInt<P>, stored row-major.
+// Integer arithmetic throws std::overflow_error instead of wrapping around;
+// InverseMatrix(), Solve() and Rank() need a field, i.e. S21ModInt.
+template <typename T>
+class S21IntegerMatrix {
+  static_assert(std::is_same<T, std::int64_t>::value || S21IsModInt<T>::value,
+                "T must be std::int64_t or S21ModInt<P>");
+
+ public:
+  S21IntegerMatrix(int rows, int cols) : rows_(rows), cols_(cols) {
+    if (rows < 1 || cols < 1) {
+      S21Throw(S21Status::kInvalidSize);
+    }
+    data_.assign(Offset(rows, 0), T(0));
+  }
+
+  // Elements must be integers; modular matrices reduce them.
+  static S21IntegerMatrix FromMatrix(const S21Matrix &matrix) {
+    S21IntegerMatrix result(matrix.GetRows(), matrix.GetCols());
+    std::transform(matrix.begin(), matrix.end(), result.data_.begin(),
+                   [](double value) {
+                     if (value != std::nearbyint(value) ||
+                         std::fabs(value) >= 0x1p63) {
+                       S21Throw(S21Status::kInvalidArgument,
+                                "Matrix element is not an int64 integer.");
+                     }
+                     return T(static_cast<std::int64_t>(value));
+                   });
+    return result;
+  }
+
+  // Integer elements beyond 2^53 are rounded; modular ones map to [0, P).
+  S21Matrix ToMatrix() const {
+    S21Matrix result(rows_, cols_);
+    std::transform(data_.begin(), data_.end(), result.begin(),
+                   [](T value) { return ToDouble(value); });
+    return result;
+  }
+
+  int GetRows() const { return rows_; }
+  int GetCols() const { return cols_; }
+
+  T &operator()(int row, int col) {
+    CheckIndex(row, col);
+    return data_[Offset(row, col)];
+  }
+  const T &operator()(int row, int col) const {
+    CheckIndex(row, col);
+    return data_[Offset(row, col)];
+  }
+
+  void SumMatrix(const S21IntegerMatrix &other) {
+    CheckSame(other);
+    for (std::size_t i = 0; i < data_.size(); ++i) {
+      data_[i] = Add(data_[i], other.data_[i]);
+    }
+  }
+
+  void SubMatrix(const S21IntegerMatrix &other) {
+    CheckSame(other);
+    for (std::size_t i = 0; i < data_.size(); ++i) {
+      data_[i] = Add(data_[i], Negate(other.data_[i]));
+    }
+  }
+
+  void MulMatrix(const S21IntegerMatrix &other) {
+    if (cols_ != other.rows_) {
+      S21Throw(S21Status::kProductMismatch);
+    }
+    S21IntegerMatrix result(rows_, other.cols_);
+    std::size_t row_work = static_cast<std::size_t>(cols_) * other.cols_;
+    std::size_t grain = std::max<std::size_t>(1, kParallelWork / row_work);
+    S21Parallel::For(0, rows_, grain, [&](std::size_t first,
+                                          std::size_t last) {
+      MultiplyRows(other, result, first, last);
+    });
+    *this = std::move(result);
+  }
+
+  S21IntegerMatrix Transpose() const {
+    S21IntegerMatrix result(cols_, rows_);
+    for (int i = 0; i < rows_; ++i) {
+      for (int j = 0; j < cols_; ++j) {
+        result.data_[result.Offset(j, i)] = data_[Offset(i, j)];
+      }
+    }
+    return result;
+  }
+
+  // Exact, in O(n^3): Bareiss fraction-free elimination for integers,
+  // Gaussian elimination for a prime field.
+  T Determinant() const {
+    CheckSquare();
+    if constexpr (S21IsModInt<T>::value) {
+      T determinant;
+      S21IntegerMatrix(*this).Eliminate(nullptr, &determinant);
+      return determinant;
+    } else {
+      return BareissDeterminant();
+    }
+  }
+
+  int Rank() const {
+    static_assert(S21IsModInt<T>::value, "Rank() needs a prime field");
+    return S21IntegerMatrix(*this).Eliminate(nullptr, nullptr);
+  }
+
+  // Gauss-Jordan elimination on [A | b].
+  S21IntegerMatrix Solve(const S21IntegerMatrix &b) const {
+    static_assert(S21IsModInt<T>::value, "Solve() needs a prime field");
+    CheckSquare();
+    if (b.rows_ != rows_) {
+      S21Throw(S21Status::kDimensionMismatch,
+               "The number of rows of the right-hand side does not equal "
+               "the size of the matrix.");
+    }
+    S21IntegerMatrix x(b);
+    if (S21IntegerMatrix(*this).Eliminate(&x, nullptr) < rows_) {
+      S21Throw(S21Status::kSingular);
+    }
+    return x;
+  }
+
+  S21IntegerMatrix InverseMatrix() const {
+    static_assert(S21IsModInt<T>::value, "InverseMatrix() needs a field");
+    CheckSquare();
+    S21IntegerMatrix identity(rows_, rows_);
+    for (int i = 0; i < rows_; ++i) identity.data_[Offset(i, i)] = T(1);
+    return Solve(identity);
+  }
+
+  S21IntegerMatrix operator+(const S21IntegerMatrix &other) const {
+    S21IntegerMatrix result(*this);
+    result.SumMatrix(other);
+    return result;
+  }
+  S21IntegerMatrix operator-(const S21IntegerMatrix &other) const {
+    S21IntegerMatrix result(*this);
+    result.SubMatrix(other);
+    return result;
+  }
+  S21IntegerMatrix operator*(const S21IntegerMatrix &other) const {
+    S21IntegerMatrix result(*this);
+    result.MulMatrix(other);
+    return result;
+  }
+  bool operator==(const S21IntegerMatrix &other) const {
+    return rows_ == other.rows_ && cols_ == other.cols_ &&
+           data_ == other.data_;
+  }
+
+ private:
+  // Same thresholds as the double kernels: small products and eliminations
+  // are not worth a thread fork.
+  static const std::size_t kParallelWork = 1 << 15;
+  static const int kParallelRows = 192;
+  static const int kGrainRows = 64;
+
+  std::size_t Offset(int row, int col) const {
+    return static_cast<std::size_t>(row) * cols_ + col;
+  }
+  T *Row(int row) { return data_.data() + Offset(row, 0); }
+  const T *Row(int row) const { return data_.data() + Offset(row, 0); }
+
+  void CheckIndex(int row, int col) const {
+    if (row >= rows_ || col >= cols_ || row < 0 || col < 0) {
+      S21Throw(S21Status::kIndexOutOfRange);
+    }
+  }
+  void CheckSame(const S21IntegerMatrix &other) const {
+    if (rows_ != other.rows_ || cols_ != other.cols_) {
+      S21Throw(S21Status::kDimensionMismatch);
+    }
+  }
+  void CheckSquare() const {
+    if (rows_ != cols_) {
+      S21Throw(S21Status::kNotSquare);
+    }
+  }
+
+  static double ToDouble(T value) {
+    if constexpr (S21IsModInt<T>::value) {
+      return value.Value();
+    } else {
+      return static_cast<double>(value);
+    }
+  }
+
+  static void CheckOverflow(bool overflow) {
+    if (overflow) S21Throw(S21Status::kOverflow);
+  }
+  static T Add(T a, T b) {
+    if constexpr (S21IsModInt<T>::value) {
+      return a + b;
+    } else {
+      std::int64_t sum;
+      CheckOverflow(__builtin_add_overflow(a, b, &sum));
+      return sum;
+    }
+  }
+  static T Multiply(T a, T b) {
+    if constexpr (S21IsModInt<T>::value) {
+      return a * b;
+    } else {
+      std::int64_t product;
+      CheckOverflow(__builtin_mul_overflow(a, b, &product));
+      return product;
+    }
+  }
+  static T Negate(T a) {
+    if constexpr (S21IsModInt<T>::value) {
+      return -a;
+    } else {
+      CheckOverflow(a == std::numeric_limits<std::int64_t>::min());
+      return -a;
+    }
+  }
+
+  // i-k-j order as in the double GEMM. Modular rows accumulate raw 64-bit
+  // products of reduced values and reduce only every kDelay terms, which
+  // keeps the inner loop a plain multiply-add the compiler can vectorize.
+  void MultiplyRows(const S21IntegerMatrix &other, S21IntegerMatrix &result,
+                    std::size_t first, std::size_t last) const {
+    const int n = other.cols_;
+    if constexpr (S21IsModInt<T>::value) {
+      constexpr std::uint64_t kMax = T::kModulus - 1;
+      constexpr std::uint64_t kDelay = (~0ull - kMax) / (kMax * kMax);
+      std::vector<std::uint64_t> accumulator(n);
+      for (std::size_t i = first; i < last; ++i) {
+        std::fill(accumulator.begin(), accumulator.end(), 0);
+        std::uint64_t *acc = accumulator.data();
+        const T *ai = Row(static_cast<int>(i));
+        std::uint64_t pending = 0;
+        for (int p = 0; p < cols_; ++p) {
+          std::uint64_t aip = ai[p].Value();
+          const T *bp = other.Row(p);
+          for (int j = 0; j < n; ++j) acc[j] += aip * bp[j].Value();
+          if (++pending == kDelay) {
+            for (int j = 0; j < n; ++j) acc[j] %= T::kModulus;
+            pending = 0;
+          }
+        }
+        T *ci = result.Row(static_cast<int>(i));
+        for (int j = 0; j < n; ++j) {
+          ci[j] = T(static_cast<std::int64_t>(acc[j] % T::kModulus));
+        }
+      }
+    } else {
+      for (std::size_t i = first; i < last; ++i) {
+        const T *ai = Row(static_cast<int>(i));
+        T *ci = result.Row(static_cast<int>(i));
+        for (int p = 0; p < cols_; ++p) {
+          const T *bp = other.Row(p);
+          for (int j = 0; j < n; ++j) {
+            ci[j] = Add(ci[j], Multiply(ai[p], bp[j]));
+          }
+        }
+      }
+    }
+  }
+
+  // Runs body(first, last) over rows [begin, end), in parallel when large.
+  template <typename Body>
+  static void ForRows(int begin, int end, Body body) {
+    if (end - begin > kParallelRows) {
+      S21Parallel::For(begin, end, kGrainRows, body);
+    } else if (begin < end) {
+      body(begin, end);
+    }
+  }
+
+  // Every entry after step k is a (k + 1) x (k + 1) minor of the input, so
+  // the division by the previous pivot is exact. 128-bit intermediates keep
+  // the cross products exact; only minors outside int64 overflow.
+  std::int64_t BareissDeterminant() const {
+    S21IntegerMatrix a(*this);
+    const int n = rows_;
+    std::int64_t sign = 1;
+    std::int64_t previous = 1;
+    for (int k = 0; k < n - 1; ++k) {
+      if (a.data_[Offset(k, k)] == 0) {
+        int pivot = k + 1;
+        while (pivot < n && a.data_[Offset(pivot, k)] == 0) ++pivot;
+        if (pivot == n) return 0;
+        std::swap_ranges(a.Row(k), a.Row(k) + n, a.Row(pivot));
+        sign = -sign;
+      }
+      const std::int64_t *ak = a.Row(k);
+      std::atomic<bool> overflow(false);
+      ForRows(k + 1, n, [&](std::size_t first, std::size_t last) {
+        bool local = false;
+        for (std::size_t i = first; i < last; ++i) {
+          std::int64_t *ai = a.Row(static_cast<int>(i));
+          for (int j = k + 1; j < n; ++j) {
+            __int128 value =
+                (static_cast<__int128>(ai[j]) * ak[k] -
+                 static_cast<__int128>(ai[k]) * ak[j]) / previous;
+            local |= value > std::numeric_limits<std::int64_t>::max() ||
+                     value < std::numeric_limits<std::int64_t>::min();
+            ai[j] = static_cast<std::int64_t>(value);
+          }
+        }
+        if (local) overflow = true;
+      });
+      CheckOverflow(overflow);
+      previous = ak[k];
+    }
+    return Multiply(sign, a.data_[Offset(n - 1, n - 1)]);
+  }
+
+  // Gauss-Jordan over the field, in place. Pivot rows are normalized to 1;
+  // with a right-hand side the rows above the pivot are cleared too and rhs
+  // ends up holding the solution. Returns the rank.
+  int Eliminate(S21IntegerMatrix *rhs, T *determinant) {
+    T product = 1;
+    int rank = 0;
+    for (int col = 0; col < cols_ && rank < rows_; ++col) {
+      int pivot = rank;
+      while (pivot < rows_ && data_[Offset(pivot, col)] == T(0)) ++pivot;
+      if (pivot == rows_) continue;
+      if (pivot != rank) {
+        std::swap_ranges(Row(rank) + col, Row(rank) + cols_, Row(pivot) + col);
+        if (rhs) {
+          std::swap_ranges(rhs->Row(rank), rhs->Row(rank) + rhs->cols_,
+                           rhs->Row(pivot));
+        }
+        product = -product;
+      }
+      T *pivot_row = Row(rank);
+      product *= pivot_row[col];
+      T inverse = pivot_row[col].Inverse();
+      for (int j = col; j < cols_; ++j) pivot_row[j] *= inverse;
+      T *pivot_rhs = rhs ? rhs->Row(rank) : nullptr;
+      if (rhs) {
+        for (int j = 0; j < rhs->cols_; ++j) pivot_rhs[j] *= inverse;
+      }
+      ForRows(rhs ? 0 : rank + 1, rows_, [&](std::size_t first,
+                                             std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+          if (static_cast<int>(i) == rank) continue;
+          T *row = Row(static_cast<int>(i));
+          T factor = row[col];
+          if (factor == T(0)) continue;
+          for (int j = col; j < cols_; ++j) row[j] -= factor * pivot_row[j];
+          if (rhs) {
+            T *row_rhs = rhs->Row(static_cast<int>(i));
+            for (int j = 0; j < rhs->cols_; ++j) {
+              row_rhs[j] -= factor * pivot_rhs[j];
+            }
+          }
+        }
+      });
+      ++rank;
+    }
+    if (determinant) *determinant = rank == rows_ ? product : T(0);
+    return rank;
+  }
+
+  int rows_, cols_;
+  std::vector<T> data_;
+};
+
+using S21Int64Matrix = S21IntegerMatrix<std::int64_t>;
+template <std::uint32_t P>
+using S21ModularMatrix = S21IntegerMatrix<S21ModInt<P>>;
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_INTEGER_H
@@ -0,0 +1,348 @@
+#include "s21_kernels.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "s21_parallel.h"
+
+namespace {
+
+using Tiles = S21Kernels::Tiles;
+
+// Neighbouring elements of a row of c that a kernel step accumulates in
+// registers; a fixed-length loop over them is what the compiler turns into
+// SIMD code.
+const int kLanes = 8;
+
+// Products smaller than this many multiply-adds per chunk stay serial.
+const std::size_t kParallelWork = 1 << 15;
+
+// Tiles of the blocked kernel until tuned: a 64 x 256 tile of b takes
+// 128 KiB, a typical per-core share of L2.
+const Tiles kDefaultTiles = {64, 256};
+
+// Candidates timed by the autotuner, each on a slice of about kTuneWork
+// multiply-adds, best of kTuneRuns.
+const int kTileK[] = {32, 64, 128, 256};
+const int kTileN[] = {128, 512, 2048};
+const std::size_t kTuneWork = 1 << 22;
+const int kTuneRuns = 3;
+
+struct Operands {
+  const double *a;
+  const double *b;
+  double *c;
+  int m;
+  int k;
+  int n;
+  Tiles tiles;
+};
+
+// Adds rows [row_first, row_last) x columns [col_first, col_last) of a * b
+// to c.
+using Kernel = void (*)(const Operands &, int row_first, int row_last,
+                        int col_first, int col_last);
+
+// Inner dimension K: the K elements of a row of a stay in registers while
+// the row of c is swept once, instead of K times.
+template <int K>
+void SmallInner(const Operands &o, int row_first, int row_last, int col_first,
+                int col_last) {
+  const int n = o.n;
+  for (int i = row_first; i < row_last; ++i) {
+    const double *a = o.a + static_cast<std::size_t>(i) * K;
+    double ai[K];
+    for (int p = 0; p < K; ++p) ai[p] = a[p];
+    double *ci = o.c + static_cast<std::size_t>(i) * n;
+    int j = col_first;
+    for (; j + kLanes <= col_last; j += kLanes) {
+      double acc[kLanes];
+      for (int l = 0; l < kLanes; ++l) acc[l] = ci[j + l];
+      for (int p = 0; p < K; ++p) {
+        const double *bp = o.b + static_cast<std::size_t>(p) * n + j;
+        for (int l = 0; l < kLanes; ++l) acc[l] += ai[p] * bp[l];
+      }
+      for (int l = 0; l < kLanes; ++l) ci[j + l] = acc[l];
+    }
+    for (; j < col_last; ++j) {
+      double sum = ci[j];
+      for (int p = 0; p < K; ++p) {
+        sum += ai[p] * o.b[static_cast<std::size_t>(p) * n + j];
+      }
+      ci[j] = sum;
+    }
+  }
+}
+
+// N columns: the whole row of c stays in registers over the inner
+// dimension. Always called with all columns.
+template <int N>
+void SmallOuter(const Operands &o, int row_first, int row_last, int, int) {
+  const int k = o.k;
+  for (int i = row_first; i < row_last; ++i) {
+    const double *ai = o.a + static_cast<std::size_t>(i) * k;
+    double *ci = o.c + static_cast<std::size_t>(i) * N;
+    double acc[N];
+    for (int l = 0; l < N; ++l) acc[l] = ci[l];
+    for (int p = 0; p < k; ++p) {
+      double aip = ai[p];
+      const double *bp = o.b + static_cast<std::size_t>(p) * N;
+      for (int l = 0; l < N; ++l) acc[l] += aip * bp[l];
+    }
+    for (int l = 0; l < N; ++l) ci[l] = acc[l];
+  }
+}
+
+// R rows of c times the tile [k_first, k_last) x [col_first, col_last) of
+// b, each b load feeding R accumulators.
+template <int R>
+void RowBlock(const Operands &o, int i, int k_first, int k_last,
+              int col_first, int col_last) {
+  const int k = o.k;
+  const int n = o.n;
+  const double *a = o.a + static_cast<std::size_t>(i) * k;
+  double *c = o.c + static_cast<std::size_t>(i) * n;
+  int j = col_first;
+  for (; j + kLanes <= col_last; j += kLanes) {
+    double acc[R][kLanes];
+    for (int r = 0; r < R; ++r) {
+      for (int l = 0; l < kLanes; ++l) acc[r][l] = c[r * n + j + l];
+    }
+    for (int p = k_first; p < k_last; ++p) {
+      const double *bp = o.b + static_cast<std::size_t>(p) * n + j;
+      for (int r = 0; r < R; ++r) {
+        double arp = a[r * k + p];
+        for (int l = 0; l < kLanes; ++l) acc[r][l] += arp * bp[l];
+      }
+    }
+    for (int r = 0; r < R; ++r) {
+      for (int l = 0; l < kLanes; ++l) c[r * n + j + l] = acc[r][l];
+    }
+  }
+  for (; j < col_last; ++j) {
+    for (int r = 0; r < R; ++r) {
+      double sum = c[r * n + j];
+      for (int p = k_first; p < k_last; ++p) {
+        sum += a[r * k + p] * o.b[static_cast<std::size_t>(p) * n + j];
+      }
+      c[r * n + j] = sum;
+    }
+  }
+}
+
+// General shapes: a tile of b stays in cache while every row of the range
+// passes over it, two rows at a time.
+void Blocked(const Operands &o, int row_first, int row_last, int col_first,
+             int col_last) {
+  for (int k_first = 0; k_first < o.k; k_first += o.tiles.k) {
+    int k_last = std::min(o.k, k_first + o.tiles.k);
+    for (int j = col_first; j < col_last; j += o.tiles.n) {
+      int j_last = std::min(col_last, j + o.tiles.n);
+      int i = row_first;
+      for (; i + 2 <= row_last; i += 2) {
+        RowBlock<2>(o, i, k_first, k_last, j, j_last);
+      }
+      if (i < row_last) RowBlock<1>(o, i, k_first, k_last, j, j_last);
+    }
+  }
+}
+
+// Dispatch tables of the fixed-size kernels, entry d - 1 for size d.
+template <std::size_t... I>
+constexpr std::array<Kernel, sizeof...(I)> SmallInnerKernels(
+    std::index_sequence<I...>) {
+  return {{&SmallInner<static_cast<int>(I) + 1>...}};
+}
+
+template <std::size_t... I>
+constexpr std::array<Kernel, sizeof...(I)> SmallOuterKernels(
+    std::index_sequence<I...>) {
+  return {{&SmallOuter<static_cast<int>(I) + 1>...}};
+}
+
+constexpr std::array<Kernel, S21Kernels::kMaxFixed> kSmallInner =
+    SmallInnerKernels(std::make_index_sequence<S21Kernels::kMaxFixed>());
+constexpr std::array<Kernel, S21Kernels::kMaxFixed> kSmallOuter =
+    SmallOuterKernels(std::make_index_sequence<S21Kernels::kMaxFixed>());
+
+// Tuned tiles by shape class, and where they persist.
+using ShapeClass = std::tuple<int, int, int>;
+
+struct Tuning {
+  std::mutex mutex;
+  std::string path = "s21_matrix.tuning";
+  bool loaded = false;
+  std::map<ShapeClass, Tiles> tiles;
+};
+
+Tuning &GetTuning() {
+  static Tuning tuning;
+  return tuning;
+}
+
+int Log2(int value) {
+  int log = 0;
+  while (value >>= 1) ++log;
+  return log;
+}
+
+ShapeClass Classify(int m, int k, int n) { return {Log2(m), Log2(k), Log2(n)}; }
+
+// Lines of "m k n tile_k tile_n", the dimensions as base-2 logarithms.
+// Unreadable lines are skipped; later lines override earlier ones.
+void Load(Tuning &tuning) {
+  if (tuning.loaded) return;
+  tuning.loaded = true;
+  if (tuning.path.empty()) return;
+  std::ifstream file(tuning.path);
+  std::string line;
+  while (std::getline(file, line)) {
+    std::istringstream fields(line);
+    int m = 0, k = 0, n = 0;
+    Tiles tiles = {};
+    if (fields >> m >> k >> n >> tiles.k >> tiles.n && tiles.k > 0 &&
+        tiles.n > 0) {
+      tuning.tiles[{m, k, n}] = tiles;
+    }
+  }
+}
+
+void Store(const Tuning &tuning, const ShapeClass &shape, Tiles tiles) {
+  if (tuning.path.empty()) return;
+  std::ofstream file(tuning.path, std::ios::app);
+  file << std::get<0>(shape) << ' ' << std::get<1>(shape) << ' '
+       << std::get<2>(shape) << ' ' << tiles.k << ' ' << tiles.n << '\n';
+}
+
+// Times the candidates serially on the leading rows of the operands, into
+// a scratch block rather than c.
+Tiles Benchmark(const Operands &o) {
+  std::size_t row_work = static_cast<std::size_t>(o.k) * o.n;
+  int rows = static_cast<int>(std::min<std::size_t>(
+      o.m, std::max<std::size_t>(1, kTuneWork / row_work)));
+  std::vector<double> scratch(static_cast<std::size_t>(rows) * o.n);
+  Operands trial = o;
+  trial.c = scratch.data();
+  Tiles best = kDefaultTiles;
+  double best_time = std::numeric_limits<double>::infinity();
+  std::vector<std::pair<int, int>> tried;
+  for (int tile_k : kTileK) {
+    for (int tile_n : kTileN) {
+      trial.tiles = {std::min(tile_k, o.k), std::min(tile_n, o.n)};
+      std::pair<int, int> key(trial.tiles.k, trial.tiles.n);
+      if (std::find(tried.begin(), tried.end(), key) != tried.end()) continue;
+      tried.push_back(key);
+      for (int run = 0; run < kTuneRuns; ++run) {
+        std::fill(scratch.begin(), scratch.end(), 0.0);
+        auto start = std::chrono::steady_clock::now();
+        Blocked(trial, 0, rows, 0, o.n);
+        std::chrono::duration<double> time =
+            std::chrono::steady_clock::now() - start;
+        if (time.count() < best_time) {
+          best_time = time.count();
+          best = trial.tiles;
+        }
+      }
+    }
+  }
+  return best;
+}
+
+Tiles TilesFor(const Operands &o) {
+  if (!S21Kernels::GetAutotune()) return kDefaultTiles;
+  Tuning &tuning = GetTuning();
+  std::lock_guard<std::mutex> lock(tuning.mutex);
+  Load(tuning);
+  ShapeClass shape = Classify(o.m, o.k, o.n);
+  auto found = tuning.tiles.find(shape);
+  if (found != tuning.tiles.end()) return found->second;
+  Tiles tiles = Benchmark(o);
+  tuning.tiles[shape] = tiles;
+  Store(tuning, shape, tiles);
+  return tiles;
+}
+
+}  // namespace
+
+std::atomic<bool> S21Kernels::autotune_{false};
+
+void S21Kernels::Multiply(const double *a, const double *b, double *c, int m,
+                          int k, int n) {
+  Operands o = {a, b, c, m, k, n, kDefaultTiles};
+  Kernel kernel = &Blocked;
+  if (k <= kMaxFixed) {
+    kernel = kSmallInner[k - 1];
+  } else if (n <= kMaxFixed) {
+    kernel = kSmallOuter[n - 1];
+  } else {
+    o.tiles = TilesFor(o);
+  }
+  std::size_t row_work = static_cast<std::size_t>(k) * n;
+  if (row_work * m <= kParallelWork) {
+    kernel(o, 0, m, 0, n);
+  } else if (n <= kMaxFixed || m >= S21Parallel::GetNumThreads()) {
+    std::size_t grain = std::max<std::size_t>(1, kParallelWork / row_work);
+    S21Parallel::For(0, m, grain, [&](std::size_t first, std::size_t last) {
+      kernel(o, static_cast<int>(first), static_cast<int>(last), 0, n);
+    });
+  } else {
+    // Too few rows to go around: split the columns, kLanes at a time.
+    int blocks = (n + kLanes - 1) / kLanes;
+    std::size_t block_work = static_cast<std::size_t>(m) * k * kLanes;
+    std::size_t grain = std::max<std::size_t>(1, kParallelWork / block_work);
+    S21Parallel::For(0, blocks, grain, [&](std::size_t first,
+                                           std::size_t last) {
+      kernel(o, 0, m, static_cast<int>(first) * kLanes,
+             std::min(n, static_cast<int>(last) * kLanes));
+    });
+  }
+}
+
+bool S21Kernels::GetAutotune() {
+  return autotune_.load(std::memory_order_relaxed);
+}
+
+void S21Kernels::SetAutotune(bool enabled) {
+  autotune_.store(enabled, std::memory_order_relaxed);
+}
+
+std::string S21Kernels::GetTuningFile() {
+  Tuning &tuning = GetTuning();
+  std::lock_guard<std::mutex> lock(tuning.mutex);
+  return tuning.path;
+}
+
+void S21Kernels::SetTuningFile(const std::string &path) {
+  Tuning &tuning = GetTuning();
+  std::lock_guard<std::mutex> lock(tuning.mutex);
+  tuning.path = path;
+  tuning.loaded = false;
+  tuning.tiles.clear();
+}
+
+S21Kernels::Tiles S21Kernels::GetTiles(int m, int k, int n) {
+  if (!GetAutotune()) return kDefaultTiles;
+  Tuning &tuning = GetTuning();
+  std::lock_guard<std::mutex> lock(tuning.mutex);
+  Load(tuning);
+  auto found = tuning.tiles.find(Classify(m, k, n));
+  return found == tuning.tiles.end() ? kDefaultTiles : found->second;
+}
+
+void S21Kernels::ClearTuning() {
+  Tuning &tuning = GetTuning();
+  std::lock_guard<std::mutex> lock(tuning.mutex);
+  tuning.loaded = false;
+  tuning.tiles.clear();
+}
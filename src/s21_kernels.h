@@ -0,0 +1,47 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_KERNELS_H
+#define CPP1_S21_MATRIXPLUS_S21_KERNELS_H
+
+#include <atomic>
+#include <string>
+
+// Kernels behind MulMatrix. Products whose inner dimension, or else whose
+// column count, is at most kMaxFixed run a kernel generated from a template
+// for that exact size, picked from a dispatch table; other shapes run a
+// cache-blocked loop nest. Every kernel adds the terms of each element in
+// the same order as the plain i-k-j loop, so results do not depend on the
+// kernel chosen.
+class S21Kernels {
+ public:
+  static constexpr int kMaxFixed = 8;
+
+  // Block of the shared dimension and of the columns that the blocked
+  // kernel keeps in cache while it sweeps over the rows.
+  struct Tiles {
+    int k;
+    int n;
+  };
+
+  // c += a * b for row-major a (m x k), b (k x n) and c (m x n), split over
+  // the rows, or over the columns when there are fewer rows than threads.
+  static void Multiply(const double *a, const double *b, double *c, int m,
+                       int k, int n);
+
+  // With autotuning on, the first product of each shape class (dimensions
+  // rounded down to powers of two) times every candidate tiling on a slice
+  // of its own operands and keeps the fastest. Choices are read from and
+  // appended to the tuning file, unless its path is empty. Off by default.
+  static bool GetAutotune();
+  static void SetAutotune(bool enabled);
+  static std::string GetTuningFile();  // Default "s21_matrix.tuning"
+  static void SetTuningFile(const std::string &path);
+  // Tiles the blocked kernel uses for the shape, as far as known without
+  // benchmarking: the tuned ones, else the defaults.
+  static Tiles GetTiles(int m, int k, int n);
+  // Forgets the tuned tiles held in memory; the file is left alone.
+  static void ClearTuning();
+
+ private:
+  static std::atomic<bool> autotune_;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_KERNELS_H
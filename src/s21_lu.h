@@ -0,0 +1,158 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_LU_H
+#define CPP1_S21_MATRIXPLUS_S21_LU_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "s21_memory.h"
+#include "s21_parallel.h"
+#include "s21_status.h"
+
+// LU factorization with partial pivoting, P * A = L * U, kept in one
+// row-major n x n block with the unit diagonal of L implied. T is the
+// working precision: float for the mixed-precision solver, double otherwise.
+template <typename T>
+class S21LU {
+ public:
+  // Factors the row-major n x n matrix a. Returns kSingular when a zero
+  // pivot is met, i.e. the matrix is singular in precision T, and the
+  // status of the allocation when the factors do not fit.
+  S21Status Factor(const double *a, int n) {
+    n_ = 0;
+    sign_ = 1;
+    const std::size_t size = static_cast<std::size_t>(n) * n;
+    S21Status status = lu_.Resize(size);
+    if (status == S21Status::kOk) status = pivot_.Resize(n);
+    if (status != S21Status::kOk) return status;
+    n_ = n;
+    std::copy(a, a + size, lu_.data());
+    for (int k = 0; k < n; ++k) {
+      int pivot_row = k;
+      T pivot_abs = std::abs(At(k, k));
+      for (int i = k + 1; i < n; ++i) {
+        if (std::abs(At(i, k)) > pivot_abs) {
+          pivot_abs = std::abs(At(i, k));
+          pivot_row = i;
+        }
+      }
+      pivot_[k] = pivot_row;
+      if (pivot_abs == T(0)) return S21Status::kSingular;
+      if (pivot_row != k) {
+        std::swap_ranges(Row(k), Row(k) + n, Row(pivot_row));
+        sign_ = -sign_;
+      }
+      EliminateBelow(k);
+    }
+    return S21Status::kOk;
+  }
+
+  // Solves A * X = B in place, B being a row-major n x nrhs block of V.
+  template <typename V>
+  void Solve(V *b, int nrhs) const {
+    for (int k = 0; k < n_; ++k) {
+      if (pivot_[k] != k) {
+        std::swap_ranges(b + RowOffset(k, nrhs), b + RowOffset(k + 1, nrhs),
+                         b + RowOffset(pivot_[k], nrhs));
+      }
+    }
+    for (int i = 1; i < n_; ++i) {
+      V *bi = b + RowOffset(i, nrhs);
+      for (int k = 0; k < i; ++k) {
+        V factor = static_cast<V>(At(i, k));
+        const V *bk = b + RowOffset(k, nrhs);
+        for (int j = 0; j < nrhs; ++j) bi[j] -= factor * bk[j];
+      }
+    }
+    for (int i = n_ - 1; i >= 0; --i) {
+      V *bi = b + RowOffset(i, nrhs);
+      for (int k = i + 1; k < n_; ++k) {
+        V factor = static_cast<V>(At(i, k));
+        const V *bk = b + RowOffset(k, nrhs);
+        for (int j = 0; j < nrhs; ++j) bi[j] -= factor * bk[j];
+      }
+      V inverse_pivot = V(1) / static_cast<V>(At(i, i));
+      for (int j = 0; j < nrhs; ++j) bi[j] *= inverse_pivot;
+    }
+  }
+
+  // Turns the factors into those of A + u * v^T in O(n^2) without changing
+  // the row order (Bennett's algorithm). Returns false when a pivot vanishes
+  // or a multiplier outgrows kMaxMultiplier; the factors are then unusable
+  // and the matrix must be factored again.
+  bool Update(const double *u, const double *v) {
+    std::vector<T> x(u, u + n_);
+    std::vector<T> y(v, v + n_);
+    for (int k = 0; k < n_; ++k) {
+      if (pivot_[k] != k) std::swap(x[k], x[pivot_[k]]);
+    }
+    for (int k = 0; k < n_; ++k) {
+      T *row = Row(k);
+      T pivot = row[k] + x[k] * y[k];
+      if (pivot == T(0)) return false;
+      row[k] = pivot;
+      for (int j = k + 1; j < n_; ++j) row[j] += x[k] * y[j];
+      T ratio = y[k] / pivot;
+      for (int j = k + 1; j < n_; ++j) y[j] -= ratio * row[j];
+      for (int i = k + 1; i < n_; ++i) {
+        T &multiplier = At(i, k);
+        x[i] -= x[k] * multiplier;
+        multiplier += x[i] * ratio;
+        if (std::abs(multiplier) > kMaxMultiplier) return false;
+      }
+    }
+    return true;
+  }
+
+  // Product of the pivots with the permutation sign.
+  double Determinant() const {
+    double determinant = sign_;
+    for (int k = 0; k < n_; ++k) determinant *= At(k, k);
+    return determinant;
+  }
+
+  int Size() const { return n_; }
+  T At(int row, int col) const { return lu_[RowOffset(row, n_) + col]; }
+  int Pivot(int k) const { return pivot_[k]; }
+
+ private:
+  // Trailing updates below this many rows are not worth a thread fork.
+  static const int kParallelRows = 192;
+  static const int kGrainRows = 64;
+  // Partial pivoting keeps multipliers within 1; updates that push them
+  // this far lose too many digits to keep.
+  static constexpr T kMaxMultiplier = T(1e3);
+
+  static std::size_t RowOffset(int row, int cols) {
+    return static_cast<std::size_t>(row) * cols;
+  }
+  T *Row(int row) { return lu_.data() + RowOffset(row, n_); }
+  T &At(int row, int col) { return lu_[RowOffset(row, n_) + col]; }
+
+  void EliminateBelow(int k) {
+    const T *pivot_row = Row(k);
+    T inverse_pivot = T(1) / pivot_row[k];
+    auto eliminate = [&](std::size_t first, std::size_t last) {
+      for (std::size_t i = first; i < last; ++i) {
+        T *row = Row(static_cast<int>(i));
+        T factor = row[k] * inverse_pivot;
+        row[k] = factor;
+        for (int j = k + 1; j < n_; ++j) row[j] -= factor * pivot_row[j];
+      }
+    };
+    if (n_ - k > kParallelRows) {
+      S21Parallel::For(k + 1, n_, kGrainRows, eliminate);
+    } else {
+      eliminate(k + 1, n_);
+    }
+  }
+
+  int n_ = 0;
+  int sign_ = 1;
+  S21Buffer<T> lu_;
+  S21Buffer<int> pivot_;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_LU_H
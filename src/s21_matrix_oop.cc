@@ -1,5 +1,414 @@
 #include "s21_matrix_oop.h"
 
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "s21_async.h"
+#include "s21_kernels.h"
+#include "s21_lu.h"
+#include "s21_memory.h"
+#include "s21_parallel.h"
+#include "s21_random.h"
+#include "s21_status.h"
+
+namespace {
+
+// Mixed-precision refinement gives up after this many correction steps.
+const int kMaxRefinements = 30;
+
+// Degree of the diagonal Pade approximant used by Exp(), and the norm the
+// scaled matrix is brought under before it is applied.
+const int kPadeDegree = 6;
+const double kPadeNorm = 0.5;
+
+// Largest size whose determinant and inverse come from the cofactor
+// expansion; it is exact for small integer matrices and cheaper than LU.
+const int kCofactorLimit = 3;
+
+// Low-rank updates carried over to the cached results before they are
+// dropped and recomputed from scratch, bounding the accumulated drift.
+const int kMaxCachedUpdates = 32;
+
+// Elements per chunk below which reductions stay on one thread.
+const std::size_t kReduceGrain = 1 << 14;
+
+// Products smaller than this many multiply-adds per chunk stay serial.
+const std::size_t kParallelWork = 1 << 15;
+
+// Rows of the product a low-memory MulMatrix computes at a time, as many
+// as fill this many bytes, before copying them back over the operand.
+const std::size_t kStreamTileBytes = 1 << 20;
+
+// std::max that keeps a NaN once one is seen, where std::max drops it.
+inline double MaxOrNaN(double a, double b) {
+  return a < b || std::isnan(b) ? b : a;
+}
+
+// Status of the exception being handled. In a Try* method it can only
+// come from one of the small allocations or thread starts that do not go
+// through S21Memory::TryAllocate().
+S21Status FailureStatus() noexcept {
+#if defined(__cpp_exceptions)
+  try {
+    throw;
+  } catch (const std::length_error &) {
+    return S21Status::kMemoryLimit;
+  } catch (...) {
+  }
+#endif
+  return S21Status::kOutOfMemory;
+}
+
+// Runs the body of a Try* method, returning any exception as its status.
+template <typename Body>
+auto Guarded(Body body) noexcept -> decltype(body()) {
+  S21Status status = S21Status::kOutOfMemory;
+  S21_TRY { return body(); }
+  S21_CATCH_ALL { status = FailureStatus(); }
+  return status;
+}
+
+// Rounding error of sum + value by Knuth's branch-free TwoSum, so the
+// compensated loops still vectorize.
+inline double TwoSumError(double sum, double value, double total) {
+  double value_part = total - sum;
+  return (sum - (total - value_part)) + (value - value_part);
+}
+
+// Compensated running sum; unlike plain Kahan summation it also survives
+// terms larger than the running sum.
+struct CompensatedSum {
+  double sum = 0;
+  double correction = 0;
+  void Add(double value) {
+    double t = sum + value;
+    correction += TwoSumError(sum, value, t);
+    sum = t;
+  }
+  double Result() const { return sum + correction; }
+};
+
+// c += a * b for row-major a (m x k), b (k x n), c (m x n). The fast mode
+// runs the shape-specialized kernels of s21_kernels.h. The compensated one
+// computes rows of c in parallel with the i-k-j loop order, so the inner
+// loop streams over contiguous rows of b and c.
+void Gemm(const double *a, const double *b, double *c, int m, int k, int n,
+          S21Matrix::Accuracy accuracy) {
+  if (accuracy == S21Matrix::Accuracy::kFast) {
+    S21Kernels::Multiply(a, b, c, m, k, n);
+    return;
+  }
+  std::size_t row_work = static_cast<std::size_t>(k) * n;
+  std::size_t grain = std::max<std::size_t>(1, kParallelWork / row_work);
+  S21Parallel::For(0, m, grain, [&](std::size_t first, std::size_t last) {
+    std::vector<double> correction(n);
+    for (std::size_t i = first; i < last; ++i) {
+      const double *ai = a + i * k;
+      double *ci = c + i * n;
+      std::fill(correction.begin(), correction.end(), 0.0);
+      double *comp = correction.data();
+      for (int p = 0; p < k; ++p) {
+        double aip = ai[p];
+        const double *bp = b + static_cast<std::size_t>(p) * n;
+        for (int j = 0; j < n; ++j) {
+          double value = aip * bp[j];
+          double t = ci[j] + value;
+          comp[j] += TwoSumError(ci[j], value, t);
+          ci[j] = t;
+        }
+      }
+      for (int j = 0; j < n; ++j) ci[j] += comp[j];
+    }
+  });
+}
+
+// Sums term(i) over [0, size). Each chunk keeps kLanes independent
+// accumulators so the loop is not serialized on one add; chunk results are
+// combined on the calling thread.
+template <typename Term>
+double Reduce(std::size_t size, S21Matrix::Accuracy accuracy, Term term) {
+  const std::size_t kLanes = 4;
+  std::size_t threads = S21Parallel::GetNumThreads();
+  std::size_t chunks =
+      std::max<std::size_t>(1, std::min(threads, size / kReduceGrain));
+  std::vector<CompensatedSum> partial(chunks);
+  S21Parallel::For(0, chunks, 1, [&](std::size_t first, std::size_t last) {
+    for (std::size_t chunk = first; chunk < last; ++chunk) {
+      std::size_t begin = size * chunk / chunks;
+      std::size_t end = size * (chunk + 1) / chunks;
+      CompensatedSum lanes[kLanes];
+      double fast[kLanes] = {0, 0, 0, 0};
+      std::size_t i = begin;
+      if (accuracy == S21Matrix::Accuracy::kFast) {
+        for (; i + kLanes <= end; i += kLanes) {
+          for (std::size_t l = 0; l < kLanes; ++l) fast[l] += term(i + l);
+        }
+        for (; i < end; ++i) fast[0] += term(i);
+        for (std::size_t l = 0; l < kLanes; ++l) lanes[l].sum = fast[l];
+      } else {
+        for (; i + kLanes <= end; i += kLanes) {
+          for (std::size_t l = 0; l < kLanes; ++l) lanes[l].Add(term(i + l));
+        }
+        for (; i < end; ++i) lanes[0].Add(term(i));
+      }
+      for (std::size_t l = 0; l < kLanes; ++l) {
+        partial[chunk].Add(lanes[l].sum);
+        partial[chunk].Add(lanes[l].correction);
+      }
+    }
+  });
+  CompensatedSum total;
+  for (const CompensatedSum &chunk : partial) {
+    total.Add(chunk.sum);
+    total.Add(chunk.correction);
+  }
+  return total.Result();
+}
+
+// Optimal split points of a matrix chain with dimensions dims[0..n]:
+// split[i][j] is the k at which A_i..A_j is cut into (A_i..A_k)(A_k+1..A_j).
+struct ChainPlan {
+  std::vector<std::vector<int>> split;
+  unsigned long long cost;  // Multiply-adds of the whole chain
+};
+
+ChainPlan PlanChain(const std::vector<unsigned long long> &dims) {
+  int n = static_cast<int>(dims.size()) - 1;
+  std::vector<std::vector<unsigned long long>> cost(
+      n, std::vector<unsigned long long>(n, 0));
+  ChainPlan plan{std::vector<std::vector<int>>(n, std::vector<int>(n, 0)), 0};
+  for (int length = 2; length <= n; ++length) {
+    for (int i = 0; i + length - 1 < n; ++i) {
+      int j = i + length - 1;
+      cost[i][j] = ~0ull;
+      for (int k = i; k < j; ++k) {
+        unsigned long long candidate = cost[i][k] + cost[k + 1][j] +
+                                       dims[i] * dims[k + 1] * dims[j + 1];
+        if (candidate < cost[i][j]) {
+          cost[i][j] = candidate;
+          plan.split[i][j] = k;
+        }
+      }
+    }
+  }
+  plan.cost = cost[0][n - 1];
+  return plan;
+}
+
+std::string ChainOrder(const ChainPlan &plan, int i, int j) {
+  if (i == j) return "A" + std::to_string(i);
+  int k = plan.split[i][j];
+  return "(" + ChainOrder(plan, i, k) + ChainOrder(plan, k + 1, j) + ")";
+}
+
+// Bytes an S21LU<T> of an n x n matrix holds.
+template <typename T>
+std::size_t FactorBytes(int n) {
+  return 2 * S21Memory::kAlignment +
+         static_cast<std::size_t>(n) * n * sizeof(T) + n * sizeof(int);
+}
+
+// Inverts the row-major n x n block a in place by Gauss-Jordan elimination
+// with partial pivoting, with n pivot indices as the only other storage.
+// The row swaps come back out as column swaps in reverse order. Returns
+// false on a zero pivot, leaving a garbled.
+bool InvertInPlace(double *a, int n) {
+  std::vector<int> pivot(n);
+  std::size_t grain = std::max<std::size_t>(1, kParallelWork / n);
+  for (int k = 0; k < n; ++k) {
+    double *row_k = a + static_cast<std::size_t>(k) * n;
+    int pivot_row = k;
+    double pivot_abs = std::fabs(row_k[k]);
+    for (int i = k + 1; i < n; ++i) {
+      double value = std::fabs(a[static_cast<std::size_t>(i) * n + k]);
+      if (value > pivot_abs) {
+        pivot_abs = value;
+        pivot_row = i;
+      }
+    }
+    if (pivot_abs == 0) return false;
+    pivot[k] = pivot_row;
+    if (pivot_row != k) {
+      std::swap_ranges(row_k, row_k + n,
+                       a + static_cast<std::size_t>(pivot_row) * n);
+    }
+    double inverse_pivot = 1 / row_k[k];
+    row_k[k] = 1;
+    for (int j = 0; j < n; ++j) row_k[j] *= inverse_pivot;
+    S21Parallel::For(0, n, grain, [&](std::size_t first, std::size_t last) {
+      for (std::size_t i = first; i < last; ++i) {
+        double *row_i = a + i * n;
+        double factor = row_i[k];
+        if (static_cast<int>(i) == k || factor == 0) continue;
+        row_i[k] = 0;
+        for (int j = 0; j < n; ++j) row_i[j] -= factor * row_k[j];
+      }
+    });
+  }
+  for (int k = n - 1; k >= 0; --k) {
+    if (pivot[k] == k) continue;
+    for (int i = 0; i < n; ++i) {
+      double *row_i = a + static_cast<std::size_t>(i) * n;
+      std::swap(row_i[k], row_i[pivot[k]]);
+    }
+  }
+  return true;
+}
+
+S21Matrix Product(const S21Matrix &a, const S21Matrix &b) {
+  S21Matrix result(a.GetRows(), b.GetCols());
+  Gemm(a.Data(), b.Data(), result.Data(), a.GetRows(), a.GetCols(),
+       b.GetCols(), S21Matrix::Accuracy::kFast);
+  return result;
+}
+
+// out = a * b into an existing buffer of the right shape.
+void MultiplyInto(const S21Matrix &a, const S21Matrix &b, S21Matrix &out) {
+  std::fill(out.begin(), out.end(), 0.0);
+  Gemm(a.Data(), b.Data(), out.Data(), a.GetRows(), a.GetCols(), b.GetCols(),
+       S21Matrix::Accuracy::kFast);
+}
+
+// Evaluates A_i..A_j (j > i). Single operands are used in place rather than
+// copied, so only the products themselves are allocated.
+S21Matrix EvaluateChain(const std::vector<const S21Matrix *> &chain,
+                        const ChainPlan &plan, int i, int j) {
+  int k = plan.split[i][j];
+  if (i == k && k + 1 == j) return Product(*chain[i], *chain[j]);
+  if (i == k) return Product(*chain[i], EvaluateChain(chain, plan, k + 1, j));
+  S21Matrix left = EvaluateChain(chain, plan, i, k);
+  if (k + 1 == j) return Product(left, *chain[j]);
+  return Product(left, EvaluateChain(chain, plan, k + 1, j));
+}
+
+// Runs body(first, last, partial) on one chunk of [0, size) per thread and
+// merges the partials in chunk order, so the result does not depend on
+// which thread finished first.
+template <typename Partial, typename Body, typename Merge>
+Partial ReduceChunks(std::size_t size, std::size_t grain,
+                     const Partial &identity, Body body, Merge merge) {
+  std::size_t chunks = std::max<std::size_t>(
+      1, std::min<std::size_t>(S21Parallel::GetNumThreads(), size / grain));
+  std::vector<Partial> partial(chunks, identity);
+  S21Parallel::For(0, chunks, 1, [&](std::size_t first, std::size_t last) {
+    for (std::size_t chunk = first; chunk < last; ++chunk) {
+      body(size * chunk / chunks, size * (chunk + 1) / chunks,
+           partial[chunk]);
+    }
+  });
+  Partial result = partial[0];
+  for (std::size_t chunk = 1; chunk < chunks; ++chunk) {
+    merge(result, partial[chunk]);
+  }
+  return result;
+}
+
+// True if flagged(i) holds for some i in [0, size). Elements are checked in
+// fixed-size blocks with a branch-free inner loop, which vectorizes, and
+// the scan stops at the first block containing a hit.
+template <typename Predicate>
+bool AnyInBlocks(std::size_t size, Predicate flagged) {
+  const std::size_t kBlock = 64;
+  for (std::size_t start = 0; start < size; start += kBlock) {
+    std::size_t end = std::min(size, start + kBlock);
+    bool hit = false;
+    for (std::size_t i = start; i < end; ++i) hit |= flagged(i);
+    if (hit) return true;
+  }
+  return false;
+}
+
+// Maps a double to an integer whose order matches the order of the values,
+// so the distance between two of them counts the doubles in between.
+inline std::int64_t OrderedBits(double value) {
+  std::int64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits < 0 ? std::numeric_limits<std::int64_t>::min() - bits : bits;
+}
+
+inline std::uint64_t UlpDistance(double a, double b) {
+  std::uint64_t x = static_cast<std::uint64_t>(OrderedBits(a));
+  std::uint64_t y = static_cast<std::uint64_t>(OrderedBits(b));
+  return OrderedBits(a) > OrderedBits(b) ? x - y : y - x;
+}
+
+// SplitMix64 finalizer.
+inline std::uint64_t Mix(std::uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xBF58476D1CE4E5B9ull;
+  x ^= x >> 27;
+  x *= 0x94D049BB133111EBull;
+  return x ^ (x >> 31);
+}
+
+// Index of the rounding bucket of a scaled element. Out of range values
+// saturate and every NaN shares one bucket.
+inline std::uint64_t Bucket(double scaled) {
+  if (scaled != scaled) return 0x7FF8000000000000ull;
+  const double kLimit = 9.2e18;
+  double rounded = std::nearbyint(std::max(-kLimit, std::min(kLimit, scaled)));
+  return static_cast<std::uint64_t>(static_cast<std::int64_t>(rounded));
+}
+
+// Column sums of a (of |a_ij| if absolute), accumulated row by row so the
+// inner loop runs over contiguous memory.
+std::vector<double> ColumnSums(const S21Matrix &a, bool absolute) {
+  int rows = a.GetRows(), cols = a.GetCols();
+  return ReduceChunks(
+      static_cast<std::size_t>(rows), kReduceGrain / cols + 1,
+      std::vector<double>(cols, 0.0),
+      [&](std::size_t first, std::size_t last, std::vector<double> &acc) {
+        for (std::size_t i = first; i < last; ++i) {
+          const double *row = a[i];
+          if (absolute) {
+            for (int j = 0; j < cols; ++j) acc[j] += fabs(row[j]);
+          } else {
+            for (int j = 0; j < cols; ++j) acc[j] += row[j];
+          }
+        }
+      },
+      [](std::vector<double> &acc, const std::vector<double> &other) {
+        for (std::size_t j = 0; j < acc.size(); ++j) acc[j] += other[j];
+      });
+}
+
+// r = b - a * x for row-major a (n x n), x and b (n x m).
+void Residual(const double *a, const double *x, const double *b, double *r,
+              int n, int m) {
+  S21Parallel::For(0, n, 64, [&](std::size_t first, std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+      double *ri = r + i * m;
+      std::copy(b + i * m, b + (i + 1) * m, ri);
+      for (int k = 0; k < n; ++k) {
+        double aik = a[i * n + k];
+        const double *xk = x + static_cast<std::size_t>(k) * m;
+        for (int j = 0; j < m; ++j) ri[j] -= aik * xk[j];
+      }
+    }
+  });
+}
+
+}  // namespace
+
+// Shared pointers keep the entries of a published snapshot alive for the
+// callers still reading it after a newer snapshot replaces it.
+struct S21Matrix::Cache {
+  std::uint64_t version = 0;
+  std::shared_ptr<const S21LU<double>> lu;  // Null until first factored
+  bool singular = false;
+  bool has_determinant = false;
+  double determinant = 0;
+  std::shared_ptr<const S21Matrix> inverse;
+  int updates = 0;  // RankUpdate() calls since the results were computed
+};
+
 // Default constructor
 
 S21Matrix::S21Matrix() : S21Matrix(3, 3) {}
@@ -8,7 +417,7 @@ S21Matrix::S21Matrix() : S21Matrix(3, 3) {}
 
 S21Matrix::S21Matrix(int rows, int cols) : rows_(rows), cols_(cols) {
   if ((rows_ < 1) || (cols_ < 1)) {
-    throw std::out_of_range("Error: rows and columns must be more than 0.");
+    S21Throw(S21Status::kInvalidSize);
   } else {
     MemoryAllocation();
   }
@@ -19,11 +428,7 @@ S21Matrix::S21Matrix(int rows, int cols) : rows_(rows), cols_(cols) {
 S21Matrix::S21Matrix(const S21Matrix &other)
     : rows_(other.rows_), cols_(other.cols_) {
   MemoryAllocation();
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      matrix_[i][j] = other.matrix_[i][j];
-    }
-  }
+  std::copy(other.begin(), other.end(), begin());
 }
 
 // Move constructor
@@ -32,28 +437,23 @@ S21Matrix::S21Matrix(S21Matrix &&other) {
   rows_ = other.rows_;
   cols_ = other.cols_;
   matrix_ = other.matrix_;
+  version_ = other.version_.load();
+  cache_ = std::atomic_exchange(&other.cache_, {});
   other.rows_ = other.cols_ = 0;
   other.matrix_ = nullptr;
+  other.Touch();
 }
 
 // Assignment operator
 
 S21Matrix &S21Matrix::operator=(const S21Matrix &other) {
   if (this == &other) return *this;
-  if (matrix_ != nullptr) {
-    for (int i = 0; i < rows_; ++i) {
-      delete[] matrix_[i];
-    }
-    delete[] matrix_;
-  }
+  MemoryFree();
   rows_ = other.rows_;
   cols_ = other.cols_;
   MemoryAllocation();
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) {
-      matrix_[i][j] = other.matrix_[i][j];
-    }
-  }
+  std::copy(other.begin(), other.end(), begin());
+  version_ = std::max(version_.load(), other.version_.load()) + 1;
   return *this;
 }
 
@@ -61,105 +461,102 @@ S21Matrix &S21Matrix::operator=(const S21Matrix &other) {
 
 S21Matrix &S21Matrix::operator=(S21Matrix &&other) {
   if (this == &other) return *this;
+  MemoryFree();
   rows_ = other.rows_;
   cols_ = other.cols_;
-  if (matrix_ != nullptr) {
-    for (int i = 0; i < rows_; ++i) {
-      delete[] matrix_[i];
-    }
-    delete[] matrix_;
-  }
   matrix_ = other.matrix_;
+  version_ = std::max(version_.load(), other.version_.load()) + 1;
+  std::atomic_store(&cache_, std::shared_ptr<const Cache>());
+  other.rows_ = other.cols_ = 0;
   other.matrix_ = nullptr;
+  other.Touch();
   return *this;
 }
 
 // Destructor
 
 S21Matrix::~S21Matrix() {
-  if (matrix_ != nullptr) {
-    for (int i = 0; i < rows_; ++i) {
-      delete[] matrix_[i];
-    }
-    delete[] matrix_;
-  }
-  matrix_ = nullptr;
+  MemoryFree();
   rows_ = 0;
   cols_ = 0;
 }
 
 // Matrix operations
 
-bool S21Matrix::EqMatrix(const S21Matrix &other) {
-  bool result = true;
-  if (this == &other) return result;
-  if (CheckSizeMatrix(other)) {
-    for (int i = 0; i < rows_; ++i) {
-      for (int j = 0; j < cols_; ++j) {
-        if (fabs(matrix_[i][j] - other.matrix_[i][j]) > kEps) {
-          result = false;
-          i = rows_;
-          break;
-        }
-      }
+bool S21Matrix::EqMatrix(const S21Matrix &other) const {
+  return Compare(other, Tolerance::Absolute(kEps));
+}
+
+bool S21Matrix::Compare(const S21Matrix &other,
+                        const Tolerance &tolerance) const {
+  if (!CheckSizeMatrix(other)) return false;
+  const double *a = Data();
+  const double *b = other.Data();
+  const double epsilon = tolerance.epsilon;
+  // Elements match if they are equal, which lets equal infinities through,
+  // or if their difference is finite and within the tolerance, which fails
+  // on a NaN and on an infinity against anything else.
+  switch (tolerance.mode) {
+    case Tolerance::Mode::kAbsolute:
+      return !AnyInBlocks(Size(), [a, b, epsilon](std::size_t i) {
+        double diff = a[i] - b[i];
+        return a[i] != b[i] &&
+               !(std::isfinite(diff) && fabs(diff) <= epsilon);
+      });
+    case Tolerance::Mode::kRelative:
+      return !AnyInBlocks(Size(), [a, b, epsilon](std::size_t i) {
+        double diff = a[i] - b[i];
+        return a[i] != b[i] &&
+               !(std::isfinite(diff) &&
+                 fabs(diff) <= epsilon * std::max(fabs(a[i]), fabs(b[i])));
+      });
+    case Tolerance::Mode::kUlp: {
+      const std::uint64_t ulps = static_cast<std::uint64_t>(tolerance.ulps);
+      return !AnyInBlocks(Size(), [a, b, ulps](std::size_t i) {
+        return UlpDistance(a[i], b[i]) > ulps || a[i] != a[i] || b[i] != b[i];
+      });
     }
-  } else {
-    result = false;
   }
-  return result;
+  return false;
 }
 
-void S21Matrix::SumMatrix(const S21Matrix &other) {
-  if (!CheckSizeMatrix(other)) {
-    throw std::out_of_range("Different matrix dimensions.");
-  } else {
-    for (int i = 0; i < rows_; i++) {
-      for (int j = 0; j < cols_; j++) {
-        matrix_[i][j] += other.matrix_[i][j];
-      }
-    }
+// Each element contributes Mix(index, bucket), and the contributions are
+// added, so chunks can be hashed in parallel and merged in any order.
+std::uint64_t S21Matrix::QuantizedHash(double quantum) const {
+  if (!(quantum > 0)) {
+    S21Throw(S21Status::kInvalidArgument, "Hash quantum must be positive.");
   }
+  const double *data = Data();
+  const double scale = 1 / quantum;
+  std::uint64_t hash = ReduceChunks(
+      Size(), kReduceGrain, std::uint64_t(0),
+      [data, scale](std::size_t first, std::size_t last, std::uint64_t &acc) {
+        for (std::size_t i = first; i < last; ++i) {
+          acc += Mix(i ^ (Bucket(data[i] * scale) * 0x9E3779B97F4A7C15ull));
+        }
+      },
+      [](std::uint64_t &acc, std::uint64_t other) { acc += other; });
+  return Mix(hash ^ (static_cast<std::uint64_t>(rows_) << 32 | cols_));
+}
+
+void S21Matrix::SumMatrix(const S21Matrix &other) {
+  S21ThrowIfError(TrySumMatrix(other));
 }
 
 void S21Matrix::SubMatrix(const S21Matrix &other) {
-  if (!CheckSizeMatrix(other)) {
-    throw std::out_of_range("Different matrix dimensions.");
-  } else {
-    for (int i = 0; i < rows_; i++) {
-      for (int j = 0; j < cols_; j++) {
-        matrix_[i][j] -= other.matrix_[i][j];
-      }
-    }
-  }
+  S21ThrowIfError(TrySubMatrix(other));
 }
 
 void S21Matrix::MulNumber(const double num) {
-  for (int i = 0; i < rows_; i++) {
-    for (int j = 0; j < cols_; j++) {
-      matrix_[i][j] *= num;
-    }
-  }
+  Touch();
+  for (double &value : *this) value *= num;
 }
 
-void S21Matrix::MulMatrix(const S21Matrix &other) {
-  if (cols_ != other.rows_) {
-    throw std::out_of_range(
-        "The number of columns of the first matrix does not equal the number "
-        "of rows of the second matrix.");
-  } else {
-    S21Matrix result(rows_, other.cols_);
-    for (int i = 0; i < rows_; i++) {
-      for (int j = 0; j < other.cols_; j++) {
-        for (int k = 0; k < cols_; k++) {
-          result.matrix_[i][j] += matrix_[i][k] * other.matrix_[k][j];
-        }
-      }
-    }
-    *this = result;
-  }
+void S21Matrix::MulMatrix(const S21Matrix &other, Accuracy accuracy) {
+  S21ThrowIfError(TryMulMatrix(other, accuracy));
 }
 
-S21Matrix S21Matrix::Transpose() {
+S21Matrix S21Matrix::Transpose() const {
   S21Matrix result(cols_, rows_);
   for (int i = 0; i < rows_; i++) {
     for (int j = 0; j < cols_; j++) {
@@ -169,7 +566,7 @@ S21Matrix S21Matrix::Transpose() {
   return result;
 }
 
-void S21Matrix::MinorMatrix(int row, int col, S21Matrix &smaller) {
+void S21Matrix::MinorMatrix(int row, int col, S21Matrix &smaller) const {
   int x = 0;
   for (int i = 0; i < rows_; i++) {
     if (i == row) continue;
@@ -183,11 +580,16 @@ void S21Matrix::MinorMatrix(int row, int col, S21Matrix &smaller) {
   }
 }
 
-S21Matrix S21Matrix::CalcComplements() {
+S21Matrix S21Matrix::CalcComplements() const {
   if (cols_ != rows_) {
-    throw std::out_of_range("The matrix is not square.");
+    S21Throw(S21Status::kNotSquare);
   }
   S21Matrix result(*this);
+  if (rows_ == 1) {
+    // The minor is empty, and its determinant 1.
+    result.matrix_[0][0] = 1;
+    return result;
+  }
   for (int i = 0; i < rows_; i++) {
     for (int j = 0; j < cols_; j++) {
       S21Matrix smaller_matrix(rows_ - 1, cols_ - 1);
@@ -199,50 +601,672 @@ S21Matrix S21Matrix::CalcComplements() {
   return result;
 }
 
-double S21Matrix::Determinant() {
+double S21Matrix::Determinant() const {
+  return TryDeterminant().ValueOrThrow();
+}
+
+S21Matrix S21Matrix::InverseMatrix() const {
+  return TryInverseMatrix().ValueOrThrow();
+}
+
+S21Matrix S21Matrix::InverseMatrix(Precision precision) const {
+  return TryInverseMatrix(precision).ValueOrThrow();
+}
+
+S21Matrix S21Matrix::Solve(const S21Matrix &b, Precision precision) const {
+  return TrySolve(b, precision).ValueOrThrow();
+}
+
+// Non-throwing API
+
+S21Result<S21Matrix> S21Matrix::TryCreate(int rows, int cols) noexcept {
+  if (rows < 1 || cols < 1) return S21Status::kInvalidSize;
+  S21Result<double *> block = S21Memory::TryAllocate(rows, cols);
+  if (!block) return block.GetStatus();
+  double **matrix = RowPointers(*block, rows, cols);
+  if (matrix == nullptr) {
+    S21Memory::Free(*block);
+    return S21Status::kOutOfMemory;
+  }
+  return S21Matrix(rows, cols, matrix);
+}
+
+S21Result<S21Matrix> S21Matrix::TryCopy() const noexcept {
+  S21Result<S21Matrix> copy = TryCreate(rows_, cols_);
+  if (copy) std::copy(begin(), end(), copy->begin());
+  return copy;
+}
+
+S21Status S21Matrix::TrySumMatrix(const S21Matrix &other) noexcept {
+  if (!CheckSizeMatrix(other)) return S21Status::kDimensionMismatch;
+  Touch();
+  double *dst = Data();
+  const double *src = other.Data();
+  const std::size_t size = Size();
+  for (std::size_t i = 0; i < size; ++i) dst[i] += src[i];
+  return S21Status::kOk;
+}
+
+S21Status S21Matrix::TrySubMatrix(const S21Matrix &other) noexcept {
+  if (!CheckSizeMatrix(other)) return S21Status::kDimensionMismatch;
+  Touch();
+  double *dst = Data();
+  const double *src = other.Data();
+  const std::size_t size = Size();
+  for (std::size_t i = 0; i < size; ++i) dst[i] -= src[i];
+  return S21Status::kOk;
+}
+
+S21Status S21Matrix::TryMulMatrix(const S21Matrix &other,
+                                  Accuracy accuracy) noexcept {
+  return Guarded([&]() -> S21Status {
+    if (cols_ != other.rows_) return S21Status::kProductMismatch;
+    if (S21Memory::IsLowMemory() && other.rows_ == other.cols_ &&
+        &other != this) {
+      return StreamMulMatrix(other, accuracy);
+    }
+    S21Result<S21Matrix> result = TryCreate(rows_, other.cols_);
+    if (!result) return result.GetStatus();
+    Gemm(Data(), other.Data(), result->Data(), rows_, cols_, other.cols_,
+         accuracy);
+    *this = std::move(*result);
+    return S21Status::kOk;
+  });
+}
+
+// this = this * other for a square 'other', a tile of rows at a time
+// through a scratch block, so only the tile is needed on top of the
+// operands. Each row of the product depends only on its own row of this,
+// so the result is the same as from the full product.
+S21Status S21Matrix::StreamMulMatrix(const S21Matrix &other,
+                                     Accuracy accuracy) {
+  const int n = cols_;
+  int tile = std::min<std::size_t>(
+      rows_, std::max<std::size_t>(1, kStreamTileBytes / (n * sizeof(double))));
+  while (tile > 1 && !S21Memory::Fits(S21Memory::BlockBytes(tile, n))) {
+    tile /= 2;
+  }
+  S21Result<S21Matrix> product = TryCreate(tile, n);
+  if (!product) return product.GetStatus();
+  Touch();
+  double *data = Data();
+  for (int first = 0; first < rows_; first += tile) {
+    int rows = std::min(tile, rows_ - first);
+    double *block = data + static_cast<std::size_t>(first) * n;
+    std::fill(product->begin(), product->begin() + rows * n, 0.0);
+    Gemm(block, other.Data(), product->Data(), rows, n, n, accuracy);
+    std::copy(product->begin(), product->begin() + rows * n, block);
+  }
+  return S21Status::kOk;
+}
+
+S21Result<double> S21Matrix::TryDeterminant() const noexcept {
+  return Guarded([&]() -> S21Result<double> {
+    if (cols_ != rows_) return S21Status::kNotSquare;
+    if (rows_ > kCofactorLimit) {
+      Cache cache = CurrentCache();
+      if (!cache.has_determinant) {
+        if (!cache.lu && !S21Memory::Fits(FactorBytes<double>(rows_))) {
+          return S21Status::kMemoryLimit;
+        }
+        S21Result<Cache> factored = FactoredCache();
+        if (!factored) return factored.GetStatus();
+        cache = std::move(*factored);
+        cache.determinant = cache.singular ? 0 : cache.lu->Determinant();
+        cache.has_determinant = true;
+        Publish(cache);
+      }
+      return cache.determinant;
+    }
+    double determinant = 0;
+    const S21Matrix &temp = *this;
+    if (rows_ == 1) {
+      determinant = temp(0, 0);
+    } else {
+      S21Result<S21Matrix> smaller_matrix = TryCreate(rows_ - 1, cols_ - 1);
+      if (!smaller_matrix) return smaller_matrix.GetStatus();
+      for (int i = 0; i < cols_; ++i) {
+        MinorMatrix(0, i, *smaller_matrix);
+        S21Result<double> minor_determinant = smaller_matrix->TryDeterminant();
+        if (!minor_determinant) return minor_determinant;
+        determinant += pow((-1), i) * temp.matrix_[0][i] * *minor_determinant;
+      }
+    }
+    return determinant;
+  });
+}
+
+// The adjugate over the determinant, as CalcComplements().Transpose() *
+// (1 / determinant) with every block allocated through TryCreate().
+S21Result<S21Matrix> S21Matrix::TryInverseMatrix() const noexcept {
+  if (cols_ != rows_) return S21Status::kNotSquare;
+  if (rows_ > kCofactorLimit) return TryInverseMatrix(Precision::kDouble);
+  S21Result<double> determinant = TryDeterminant();
+  if (!determinant) return determinant.GetStatus();
+  if (*determinant == 0) return S21Status::kSingular;
+  const double inverse_determinant = 1 / *determinant;
+  S21Result<S21Matrix> result = TryCreate(rows_, cols_);
+  if (!result || rows_ == 1) {
+    if (result) (*result)(0, 0) = inverse_determinant;
+    return result;
+  }
+  S21Result<S21Matrix> smaller_matrix = TryCreate(rows_ - 1, cols_ - 1);
+  if (!smaller_matrix) return smaller_matrix.GetStatus();
+  for (int i = 0; i < rows_; i++) {
+    for (int j = 0; j < cols_; j++) {
+      MinorMatrix(i, j, *smaller_matrix);
+      S21Result<double> minor_determinant = smaller_matrix->TryDeterminant();
+      if (!minor_determinant) return minor_determinant.GetStatus();
+      (*result)(j, i) =
+          pow((-1), i + j) * *minor_determinant * inverse_determinant;
+    }
+  }
+  return result;
+}
+
+S21Result<S21Matrix> S21Matrix::TryInverseMatrix(
+    Precision precision) const noexcept {
+  return Guarded([&]() -> S21Result<S21Matrix> {
+    if (cols_ != rows_) return S21Status::kNotSquare;
+    if (S21Memory::IsLowMemory() && !CurrentCache().inverse) {
+      if (!S21Memory::Fits(S21Memory::BlockBytes(rows_, cols_))) {
+        return S21Status::kMemoryLimit;
+      }
+      S21Result<S21Matrix> result = TryCopy();
+      if (!result) return result;
+      if (!InvertInPlace(result->Data(), rows_)) return S21Status::kSingular;
+      return result;
+    }
+    Cache cache = CurrentCache();
+    if (cache.inverse && precision == Precision::kDouble) {
+      return cache.inverse->TryCopy();
+    }
+    S21Result<S21Matrix> identity = TryCreate(rows_, cols_);
+    if (!identity) return identity;
+    for (int i = 0; i < rows_; ++i) identity->matrix_[i][i] = 1;
+    if (precision == Precision::kMixed) return TrySolve(*identity, precision);
+    S21Result<S21Matrix> inverse = TrySolve(*identity);
+    if (!inverse) return inverse;
+    cache = CurrentCache();
+    cache.inverse = std::make_shared<const S21Matrix>(std::move(*inverse));
+    Publish(cache);
+    return cache.inverse->TryCopy();
+  });
+}
+
+S21Result<S21Matrix> S21Matrix::TrySolve(const S21Matrix &b,
+                                         Precision precision) const noexcept {
+  return Guarded([&]() -> S21Result<S21Matrix> {
+    if (cols_ != rows_) return S21Status::kNotSquare;
+    if (b.rows_ != rows_) return S21Status::kDimensionMismatch;
+    if (S21Memory::IsLowMemory()) {
+      std::size_t block = S21Memory::BlockBytes(b.rows_, b.cols_);
+      std::size_t need = block;
+      if (!CurrentCache().lu) need += FactorBytes<double>(rows_);
+      if (precision == Precision::kMixed) {
+        need = std::max(need, 2 * block + FactorBytes<float>(rows_));
+      }
+      if (!S21Memory::Fits(need)) return S21Status::kMemoryLimit;
+    }
+    S21Result<S21Matrix> x = b.TryCopy();
+    if (!x) return x;
+    if (precision == Precision::kMixed && RefineSolution(b, *x)) return x;
+    S21Result<Cache> cache = FactoredCache();
+    if (!cache) return cache.GetStatus();
+    if (cache->singular) return S21Status::kSingular;
+    std::copy(b.begin(), b.end(), x->begin());
+    cache->lu->Solve(x->Data(), x->cols_);
+    return x;
+  });
+}
+
+// One unsigned comparison per index also rejects negative values.
+double *S21Matrix::TryAt(int row, int col) noexcept {
+  if (static_cast<unsigned>(row) >= static_cast<unsigned>(rows_) ||
+      static_cast<unsigned>(col) >= static_cast<unsigned>(cols_)) {
+    return nullptr;
+  }
+  Touch();
+  return &matrix_[row][col];
+}
+
+const double *S21Matrix::TryAt(int row, int col) const noexcept {
+  if (static_cast<unsigned>(row) >= static_cast<unsigned>(rows_) ||
+      static_cast<unsigned>(col) >= static_cast<unsigned>(cols_)) {
+    return nullptr;
+  }
+  return &matrix_[row][col];
+}
+
+// Result caching
+
+S21Matrix::Cache S21Matrix::CurrentCache() const {
+  std::shared_ptr<const Cache> cache = std::atomic_load(&cache_);
+  if (cache && cache->version == version_) return *cache;
+  Cache fresh;
+  fresh.version = version_;
+  return fresh;
+}
+
+// Low-memory mode keeps only the scalar results: held factors and
+// inverses would take up memory the limit leaves for the caller.
+void S21Matrix::Publish(Cache cache) const {
+  if (S21Memory::IsLowMemory()) {
+    cache.lu.reset();
+    cache.inverse.reset();
+  }
+  cache.version = version_;
+  std::atomic_store(&cache_, std::make_shared<const Cache>(std::move(cache)));
+}
+
+// Concurrent first calls may both factor; the later snapshot wins and the
+// results are identical.
+S21Result<S21Matrix::Cache> S21Matrix::FactoredCache() const {
+  Cache cache = CurrentCache();
+  if (!cache.lu) {
+    auto lu = std::make_shared<S21LU<double>>();
+    S21Status status = lu->Factor(Data(), rows_);
+    if (status != S21Status::kOk && status != S21Status::kSingular) {
+      return status;
+    }
+    cache.singular = status == S21Status::kSingular;
+    cache.lu = std::move(lu);
+    Publish(cache);
+  }
+  return cache;
+}
+
+// Low-rank updates
+
+void S21Matrix::RankUpdate(const S21Matrix &u, const S21Matrix &v,
+                           double alpha) {
+  if (u.rows_ != rows_ || v.rows_ != cols_ || u.cols_ != v.cols_) {
+    S21Throw(S21Status::kDimensionMismatch);
+  }
+  Cache cache = CurrentCache();
+  const S21Matrix scaled = u * alpha;
+  const S21Matrix vt = v.Transpose();
+  Touch();
+  Gemm(scaled.Data(), vt.Data(), Data(), rows_, u.cols_, cols_,
+       Accuracy::kFast);
+  if ((cache.lu || cache.inverse) && cache.updates < kMaxCachedUpdates) {
+    Publish(UpdatedCache(cache, scaled, vt));
+  }
+}
+
+// Carries the cached results over A + U * V^T: the LU factors by k rank-1
+// updates, the inverse by the Sherman-Morrison-Woodbury formula
+// (A + U V^T)^-1 = A^-1 - A^-1 U (I + V^T A^-1 U)^-1 V^T A^-1, and the
+// determinant by the matrix determinant lemma when the LU does not survive.
+S21Matrix::Cache S21Matrix::UpdatedCache(const Cache &cache,
+                                         const S21Matrix &u,
+                                         const S21Matrix &vt) const {
+  Cache next;
+  next.updates = cache.updates + 1;
+  const int k = u.cols_;
+  if (cache.lu && !cache.singular) {
+    auto lu = std::make_shared<S21LU<double>>(*cache.lu);
+    const S21Matrix ut = u.Transpose();
+    bool updated = true;
+    for (int p = 0; p < k && updated; ++p) updated = lu->Update(ut[p], vt[p]);
+    if (updated) {
+      next.lu = std::move(lu);
+      next.has_determinant = cache.has_determinant;
+      if (next.has_determinant) next.determinant = next.lu->Determinant();
+    }
+  }
+  if (cache.inverse) {
+    const S21Matrix &inverse = *cache.inverse;
+    const S21Matrix w = inverse * u;
+    const S21Matrix capacitance = vt * w + Identity(k);
+    S21LU<double> lu;
+    if (lu.Factor(capacitance.Data(), k) == S21Status::kOk) {
+      S21Matrix z = vt * inverse;
+      lu.Solve(z.Data(), cols_);
+      next.inverse = std::make_shared<const S21Matrix>(inverse - w * z);
+      if (cache.has_determinant && !next.has_determinant) {
+        next.determinant = cache.determinant * lu.Determinant();
+        next.has_determinant = true;
+      }
+    }
+  }
+  return next;
+}
+
+// Binary exponentiation: O(log k) products, ping-ponging between three
+// preallocated buffers so no step allocates.
+S21Matrix S21Matrix::Pow(int power) const {
   if (cols_ != rows_) {
-    throw std::out_of_range("The matrix is not square.");
+    S21Throw(S21Status::kNotSquare);
   }
-  double determinant = 0;
-  S21Matrix temp(*this);
-  if (rows_ == 1) {
-    determinant = temp(0, 0);
-  } else {
-    for (int i = 0; i < cols_; ++i) {
-      double minor_determinant = 0.0;
-      S21Matrix smaller_matrix(rows_ - 1, cols_ - 1);
-      MinorMatrix(0, i, smaller_matrix);
-      minor_determinant = smaller_matrix.Determinant();
-      determinant += pow((-1), i) * temp.matrix_[0][i] * minor_determinant;
+  if (power < 0) {
+    // A^-k = (A^-1)^(k-1) * A^-1, which stays in range for INT_MIN.
+    S21Matrix inverse = InverseMatrix(Precision::kDouble);
+    return inverse.Pow(-(power + 1)) * inverse;
+  }
+  if (IsDiagonal()) {
+    S21Matrix result(rows_, cols_);
+    for (int i = 0; i < rows_; ++i) {
+      result.matrix_[i][i] = std::pow(matrix_[i][i], power);
+    }
+    return result;
+  }
+  if (power == 0) return Identity(rows_);
+  S21Matrix base(*this), result(rows_, cols_), scratch(rows_, cols_);
+  bool first = true;
+  for (;;) {
+    if (power & 1) {
+      if (first) {
+        result = base;
+        first = false;
+      } else {
+        MultiplyInto(result, base, scratch);
+        std::swap(result, scratch);
+      }
     }
+    power >>= 1;
+    if (power == 0) break;
+    MultiplyInto(base, base, scratch);
+    std::swap(base, scratch);
   }
-  return determinant;
+  return result;
 }
 
-S21Matrix S21Matrix::InverseMatrix() {
+// Scaling and squaring: e^A = (e^(A / 2^s))^(2^s), with s chosen so that
+// ||A / 2^s|| <= kPadeNorm and e^(A / 2^s) taken from the [6/6] Pade
+// approximant D^-1 N (Golub and Van Loan, algorithm 11.3.1).
+S21Matrix S21Matrix::Exp() const {
   if (cols_ != rows_) {
-    throw std::out_of_range("The matrix is not square.");
+    S21Throw(S21Status::kNotSquare);
   }
-  S21Matrix result(*this);
-  double determinant = Determinant();
-  if (determinant == 0) {
-    throw std::out_of_range("Matrix determinant is 0.");
-  } else {
-    result = result.CalcComplements().Transpose();
-    result *= 1 / determinant;
+  if (IsDiagonal()) {
+    S21Matrix result(rows_, cols_);
+    for (int i = 0; i < rows_; ++i) {
+      result.matrix_[i][i] = std::exp(matrix_[i][i]);
+    }
+    return result;
+  }
+  double norm = NormInf();
+  if (!std::isfinite(norm)) {
+    S21Throw(S21Status::kInvalidArgument, "The matrix is not finite.");
+  }
+  int squarings = 0;
+  if (norm > kPadeNorm) {
+    squarings = static_cast<int>(std::ceil(std::log2(norm / kPadeNorm)));
+  }
+  S21Matrix a(*this);
+  a.MulNumber(std::ldexp(1.0, -squarings));
+  S21Matrix x(a), scratch(rows_, cols_);
+  S21Matrix numerator = Identity(rows_), denominator = Identity(rows_);
+  double c = 1;
+  for (int k = 1; k <= kPadeDegree; ++k) {
+    c *= static_cast<double>(kPadeDegree - k + 1) /
+         (k * (2 * kPadeDegree - k + 1));
+    if (k > 1) {
+      MultiplyInto(a, x, scratch);
+      std::swap(x, scratch);
+    }
+    for (std::size_t i = 0; i < Size(); ++i) {
+      double term = c * x.Data()[i];
+      numerator.Data()[i] += term;
+      denominator.Data()[i] += (k % 2 == 0) ? term : -term;
+    }
+  }
+  S21Matrix result = denominator.Solve(numerator);
+  for (int i = 0; i < squarings; ++i) {
+    MultiplyInto(result, result, scratch);
+    std::swap(result, scratch);
+  }
+  return result;
+}
+
+bool S21Matrix::IsDiagonal() const {
+  for (int i = 0; i < rows_; ++i) {
+    for (int j = 0; j < cols_; ++j) {
+      if (i != j && matrix_[i][j] != 0) return false;
+    }
+  }
+  return true;
+}
+
+S21Matrix S21Matrix::Identity(int size) {
+  S21Matrix result(size, size);
+  for (int i = 0; i < size; ++i) result.matrix_[i][i] = 1;
+  return result;
+}
+
+// Iterative refinement on a float LU: x += A^-1 (b - A x), with residuals in
+// double. Stops once the residual is at double rounding level (the LAPACK
+// dsgesv criterion) and reports failure if the corrections stop shrinking
+// or anything leaves the float range, which a NaN or infinite norm shows.
+bool S21Matrix::RefineSolution(const S21Matrix &b, S21Matrix &x) const {
+  S21LU<float> lu;
+  if (lu.Factor(Data(), rows_) != S21Status::kOk) return false;
+  S21Result<S21Matrix> residual_block = TryCreate(b.rows_, b.cols_);
+  if (!residual_block) return false;
+  S21Matrix &r = *residual_block;
+  const double tolerance = NormInf() * std::sqrt(rows_) * DBL_EPSILON;
+  std::copy(b.begin(), b.end(), x.begin());
+  lu.Solve(x.Data(), x.cols_);
+  double previous_step = HUGE_VAL;
+  for (int step = 0; step < kMaxRefinements; ++step) {
+    Residual(Data(), x.Data(), b.Data(), r.Data(), rows_, x.cols_);
+    double residual = r.MaxAbs();
+    double solution = x.MaxAbs();
+    if (!std::isfinite(residual) || !std::isfinite(solution)) return false;
+    if (residual <= tolerance * solution) return true;
+    lu.Solve(r.Data(), r.cols_);
+    double step_size = r.MaxAbs();
+    if (!std::isfinite(step_size) || step_size > 0.5 * previous_step) {
+      return false;
+    }
+    previous_step = step_size;
+    x.SumMatrix(r);
+  }
+  return false;
+}
+
+S21Matrix S21Matrix::MultiplyChain(const std::vector<const S21Matrix *> &chain,
+                                   ChainReport *report) {
+  if (chain.empty()) {
+    S21Throw(S21Status::kInvalidSize, "The matrix chain is empty.");
+  }
+  std::vector<unsigned long long> dims{
+      static_cast<unsigned long long>(chain[0]->rows_)};
+  for (std::size_t i = 0; i < chain.size(); ++i) {
+    if (chain[i]->rows_ != static_cast<int>(dims.back())) {
+      S21Throw(S21Status::kProductMismatch);
+    }
+    dims.push_back(chain[i]->cols_);
   }
+  int n = static_cast<int>(chain.size());
+  ChainPlan plan = PlanChain(dims);
+  if (report != nullptr) {
+    report->chosen_flops = 2 * plan.cost;
+    report->naive_flops = 0;
+    for (int i = 1; i < n; ++i) {
+      report->naive_flops += 2 * dims[0] * dims[i] * dims[i + 1];
+    }
+    report->order = ChainOrder(plan, 0, n - 1);
+  }
+  if (n == 1) return *chain[0];
+  return EvaluateChain(chain, plan, 0, n - 1);
+}
+
+// Asynchronous operations
+
+S21Future S21Matrix::SumMatrixAsync(const S21Matrix &other) const {
+  return S21Async::Sum(S21Executor::MakeReady(*this),
+                       S21Executor::MakeReady(other));
+}
+
+S21Future S21Matrix::SubMatrixAsync(const S21Matrix &other) const {
+  return S21Async::Sub(S21Executor::MakeReady(*this),
+                       S21Executor::MakeReady(other));
+}
+
+S21Future S21Matrix::MulMatrixAsync(const S21Matrix &other) const {
+  return S21Async::Mul(S21Executor::MakeReady(*this),
+                       S21Executor::MakeReady(other));
+}
+
+S21Future S21Matrix::InverseMatrixAsync() const {
+  return S21Async::Inverse(S21Executor::MakeReady(*this));
+}
+
+S21Future S21Matrix::SolveAsync(const S21Matrix &b) const {
+  return S21Async::Solve(S21Executor::MakeReady(*this),
+                         S21Executor::MakeReady(b));
+}
+
+// Reductions
+
+double S21Matrix::Sum(Accuracy accuracy) const {
+  const double *data = Data();
+  return Reduce(Size(), accuracy, [data](std::size_t i) { return data[i]; });
+}
+
+double S21Matrix::Trace(Accuracy accuracy) const {
+  if (cols_ != rows_) {
+    S21Throw(S21Status::kNotSquare);
+  }
+  const double *data = Data();
+  const std::size_t stride = cols_ + 1;
+  return Reduce(rows_, accuracy,
+                [data, stride](std::size_t i) { return data[i * stride]; });
+}
+
+double S21Matrix::FrobeniusNorm(Accuracy accuracy) const {
+  const double *data = Data();
+  return std::sqrt(Reduce(Size(), accuracy, [data](std::size_t i) {
+    return data[i] * data[i];
+  }));
+}
+
+double S21Matrix::Dot(const S21Matrix &other, Accuracy accuracy) const {
+  if (!CheckSizeMatrix(other)) {
+    S21Throw(S21Status::kDimensionMismatch);
+  }
+  const double *a = Data();
+  const double *b = other.Data();
+  return Reduce(Size(), accuracy,
+                [a, b](std::size_t i) { return a[i] * b[i]; });
+}
+
+double S21Matrix::Norm1() const {
+  std::vector<double> sums = ColumnSums(*this, true);
+  double norm = 0;
+  for (double sum : sums) norm = MaxOrNaN(norm, sum);
+  return norm;
+}
+
+double S21Matrix::NormInf() const {
+  return ReduceChunks(
+      static_cast<std::size_t>(rows_), kReduceGrain / cols_ + 1, 0.0,
+      [this](std::size_t first, std::size_t last, double &acc) {
+        for (std::size_t i = first; i < last; ++i) {
+          const double *row = matrix_[i];
+          double row_sum = 0;
+          for (int j = 0; j < cols_; ++j) row_sum += fabs(row[j]);
+          acc = MaxOrNaN(acc, row_sum);
+        }
+      },
+      [](double &acc, double other) { acc = MaxOrNaN(acc, other); });
+}
+
+double S21Matrix::MaxAbs() const {
+  const double *data = Data();
+  return ReduceChunks(
+      Size(), kReduceGrain, 0.0,
+      [data](std::size_t first, std::size_t last, double &acc) {
+        for (std::size_t i = first; i < last; ++i) {
+          acc = MaxOrNaN(acc, fabs(data[i]));
+        }
+      },
+      [](double &acc, double other) { acc = MaxOrNaN(acc, other); });
+}
+
+std::pair<int, int> S21Matrix::ArgMax() const {
+  Summary summary = Summarize();
+  return {summary.argmax_row, summary.argmax_col};
+}
+
+S21Matrix S21Matrix::RowSums() const {
+  S21Matrix result(rows_, 1);
+  S21Parallel::For(0, rows_, kReduceGrain / cols_ + 1,
+                   [&](std::size_t first, std::size_t last) {
+                     for (std::size_t i = first; i < last; ++i) {
+                       const double *row = matrix_[i];
+                       double sum = 0;
+                       for (int j = 0; j < cols_; ++j) sum += row[j];
+                       result.matrix_[i][0] = sum;
+                     }
+                   });
+  return result;
+}
+
+S21Matrix S21Matrix::ColSums() const {
+  std::vector<double> sums = ColumnSums(*this, false);
+  S21Matrix result(1, cols_);
+  std::copy(sums.begin(), sums.end(), result.begin());
   return result;
 }
 
+S21Matrix S21Matrix::RowMeans() const { return RowSums() * (1.0 / cols_); }
+
+S21Matrix S21Matrix::ColMeans() const { return ColSums() * (1.0 / rows_); }
+
+S21Matrix::Summary S21Matrix::Summarize() const {
+  const double *data = Data();
+  struct Partial {
+    Summary summary;
+    std::size_t argmax = 0;
+  };
+  Partial result = ReduceChunks(
+      Size(), kReduceGrain, Partial(),
+      [data](std::size_t first, std::size_t last, Partial &acc) {
+        Summary &s = acc.summary;
+        for (std::size_t i = first; i < last; ++i) {
+          double value = data[i];
+          s.sum += value;
+          s.sum_squares += value * value;
+          s.min = std::min(s.min, value);
+          s.max_abs = MaxOrNaN(s.max_abs, fabs(value));
+          if (value > s.max) {
+            s.max = value;
+            acc.argmax = i;
+          }
+        }
+      },
+      [](Partial &acc, const Partial &other) {
+        acc.summary.sum += other.summary.sum;
+        acc.summary.sum_squares += other.summary.sum_squares;
+        acc.summary.min = std::min(acc.summary.min, other.summary.min);
+        acc.summary.max_abs =
+            MaxOrNaN(acc.summary.max_abs, other.summary.max_abs);
+        if (other.summary.max > acc.summary.max) {
+          acc.summary.max = other.summary.max;
+          acc.argmax = other.argmax;
+        }
+      });
+  if (cols_ > 0) {
+    result.summary.argmax_row = static_cast<int>(result.argmax / cols_);
+    result.summary.argmax_col = static_cast<int>(result.argmax % cols_);
+  }
+  return result.summary;
+}
+
 // Setters and Getters
 
-int S21Matrix::GetRows() { return rows_; }
+int S21Matrix::GetRows() const { return rows_; }
 
-int S21Matrix::GetCols() { return cols_; }
+int S21Matrix::GetCols() const { return cols_; }
+
+std::uint64_t S21Matrix::GetVersion() const { return version_.load(); }
 
 void S21Matrix::SetRows(int rows) {
   if (rows < 1) {
-    throw std::out_of_range("Error: rows must be more than 0.");
+    S21Throw(S21Status::kInvalidSize, "Error: rows must be more than 0.");
   }
   S21Matrix temp(rows, cols_);
   for (int i = 0; i < rows; ++i) {
@@ -256,7 +1280,7 @@ void S21Matrix::SetRows(int rows) {
 
 void S21Matrix::SetCols(int cols) {
   if (cols < 1) {
-    throw std::out_of_range("Error: cols must be more than 0.");
+    S21Throw(S21Status::kInvalidSize, "Error: cols must be more than 0.");
   }
   S21Matrix temp(rows_, cols);
   for (int i = 0; i < rows_; ++i) {
@@ -270,27 +1294,29 @@ void S21Matrix::SetCols(int cols) {
 
 // Operators overloads
 
-bool S21Matrix::operator==(const S21Matrix &other) { return EqMatrix(other); }
+bool S21Matrix::operator==(const S21Matrix &other) const {
+  return EqMatrix(other);
+}
 
-S21Matrix S21Matrix::operator+(const S21Matrix &other) {
+S21Matrix S21Matrix::operator+(const S21Matrix &other) const {
   S21Matrix result(*this);
   result.SumMatrix(other);
   return result;
 }
 
-S21Matrix S21Matrix::operator-(const S21Matrix &other) {
+S21Matrix S21Matrix::operator-(const S21Matrix &other) const {
   S21Matrix result(*this);
   result.SubMatrix(other);
   return result;
 }
 
-S21Matrix S21Matrix::operator*(const S21Matrix &other) {
+S21Matrix S21Matrix::operator*(const S21Matrix &other) const {
   S21Matrix result(*this);
   result.MulMatrix(other);
   return result;
 }
 
-S21Matrix S21Matrix::operator*(const double num) {
+S21Matrix S21Matrix::operator*(const double num) const {
   S21Matrix result(*this);
   result.MulNumber(num);
   return result;
@@ -316,34 +1342,89 @@ S21Matrix &S21Matrix::operator*=(const double num) {
   return *this;
 }
 
-double &S21Matrix::operator()(int row, int col) {
-  if (row >= rows_ || col >= cols_ || row < 0 || col < 0) {
-    throw std::out_of_range("Index is outside the matrix.");
-  }
-  return matrix_[row][col];
+double &S21Matrix::operator()(int row, int col) { return At(row, col); }
+
+const double &S21Matrix::operator()(int row, int col) const {
+  return At(row, col);
+}
+
+// Element access
+
+double &S21Matrix::At(int row, int col) {
+  double *value = TryAt(row, col);
+  if (value == nullptr) S21Throw(S21Status::kIndexOutOfRange);
+  return *value;
+}
+
+const double &S21Matrix::At(int row, int col) const {
+  const double *value = TryAt(row, col);
+  if (value == nullptr) S21Throw(S21Status::kIndexOutOfRange);
+  return *value;
 }
 
 // Additional functions
 
+// All rows live in one zero-initialized block; matrix_ holds pointers to
+// the start of each row so the matrix_[i][j] indexing still works.
+double **S21Matrix::RowPointers(double *block, int rows, int cols) noexcept {
+  double **matrix = new (std::nothrow) double *[rows];
+  if (matrix == nullptr) return nullptr;
+  for (int i = 0; i < rows; ++i) {
+    matrix[i] = block + static_cast<std::size_t>(i) * cols;
+  }
+  return matrix;
+}
+
 void S21Matrix::MemoryAllocation() {
-  matrix_ = new double *[rows_]();
-  for (int i = 0; i < rows_; ++i) {
-    matrix_[i] = new double[cols_]();
+  if (Size() == 0) {
+    matrix_ = nullptr;
+    return;
+  }
+  double *block = S21Memory::Allocate(rows_, cols_);
+  matrix_ = RowPointers(block, rows_, cols_);
+  if (matrix_ == nullptr) {
+    S21Memory::Free(block);
+    S21Throw(S21Status::kOutOfMemory);
   }
 }
 
-void S21Matrix::RandomFillMatrix() {
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) matrix_[i][j] = rand() % 10;
+void S21Matrix::MemoryFree() {
+  if (matrix_ != nullptr) {
+    S21Memory::Free(matrix_[0]);
+    delete[] matrix_;
   }
+  matrix_ = nullptr;
+}
+
+void S21Matrix::RandomFillMatrix() {
+  std::random_device device;
+  std::uint64_t seed = (static_cast<std::uint64_t>(device()) << 32) | device();
+  IntegerFillMatrix(0, 9, seed);
+}
+
+void S21Matrix::UniformFillMatrix(double low, double high,
+                                  std::uint64_t seed) {
+  Touch();
+  S21Random::FillUniform(Data(), Size(), low, high, seed);
+}
+
+void S21Matrix::NormalFillMatrix(double mean, double stddev,
+                                 std::uint64_t seed) {
+  Touch();
+  S21Random::FillNormal(Data(), Size(), mean, stddev, seed);
+}
+
+void S21Matrix::IntegerFillMatrix(std::int64_t low, std::int64_t high,
+                                  std::uint64_t seed) {
+  Touch();
+  S21Random::FillInteger(Data(), Size(), low, high, seed);
 }
 
 void S21Matrix::NumberFillMatrix(double num) {
-  for (int i = 0; i < rows_; ++i) {
-    for (int j = 0; j < cols_; ++j) matrix_[i][j] = num;
-  }
+  Touch();
+  std::fill(begin(), end(), num);
 }
 
-bool S21Matrix::CheckSizeMatrix(const S21Matrix &other) {
+bool S21Matrix::CheckSizeMatrix(const S21Matrix &other) const {
   return (rows_ == other.rows_) && (cols_ == other.cols_);
 }
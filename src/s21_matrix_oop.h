@@ -1,14 +1,122 @@
 #ifndef CPP1_S21_MATRIXPLUS_S21_MATRIX_OOP_H
 #define CPP1_S21_MATRIXPLUS_S21_MATRIX_OOP_H
 
+#include <atomic>
+#include <cassert>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <string>
 #include <utility>  // for std::move
+#include <vector>
+
+#include "s21_status.h"
 
 const double kEps = 1e-7;
 
+class S21Future;
+class S21Transport;
+struct S21EigenResult;
+struct S21SvdResult;
+template <typename T>
+class S21LU;
+
 class S21Matrix {
  public:
+  // Contiguous view of one matrix row, usable with range-for and std
+  // algorithms. Element access is unchecked.
+  template <typename T>
+  class BasicRowSpan {
+   public:
+    BasicRowSpan(T *data, int size) : data_(data), size_(size) {}
+    T *begin() const { return data_; }
+    T *end() const { return data_ + size_; }
+    T *data() const { return data_; }
+    int size() const { return size_; }
+    T &operator[](int col) const {
+      assert(col >= 0 && col < size_);
+      return data_[col];
+    }
+
+   private:
+    T *data_;
+    int size_;
+  };
+
+  // Working precision of the LU-based solvers. kMixed factors in float and
+  // refines the solution with double residuals, falling back to a double
+  // factorization when refinement stalls.
+  enum class Precision { kDouble, kMixed };
+
+  // Accumulation mode of products and reductions. kCompensated carries a
+  // compensation term per accumulator, roughly doubling the flops.
+  enum class Accuracy { kFast, kCompensated };
+
+  // Output extent of Convolve2D() and Correlate2D() for an m x n matrix and
+  // a p x q kernel: (m+p-1) x (n+q-1), m x n centred on the full output, or
+  // (m-p+1) x (n-q+1) where the kernel fits entirely inside the matrix.
+  enum class ConvolutionMode { kFull, kSame, kValid };
+
+  // kDirect sums the taps in place, kIm2col unrolls the windows into a
+  // matrix and multiplies it by the kernel, kFft multiplies the spectra.
+  // kAuto picks by kernel and output size.
+  enum class ConvolutionMethod { kAuto, kDirect, kIm2col, kFft };
+
+  // Cost of a MultiplyChain call, counting 2 * m * k * n flops per product.
+  struct ChainReport {
+    unsigned long long chosen_flops = 0;
+    unsigned long long naive_flops = 0;  // Left-to-right evaluation
+    std::string order;                   // E.g. "(A0(A1A2))"
+  };
+
+  // Statistics gathered by Summarize() in a single sweep over the elements.
+  // The arg max is the first position holding the largest element, and
+  // max_abs is NaN if any element is, as from MaxAbs().
+  struct Summary {
+    double sum = 0;
+    double sum_squares = 0;
+    double min = HUGE_VAL;
+    double max = -HUGE_VAL;
+    double max_abs = 0;
+    int argmax_row = 0;
+    int argmax_col = 0;
+  };
+
+  // Element tolerance for Compare(): |a - b| <= epsilon (kAbsolute),
+  // |a - b| <= epsilon * max(|a|, |b|) (kRelative), or at most 'ulps'
+  // representable doubles apart (kUlp). In every mode a NaN element differs
+  // from everything, itself included, and an infinity equals only itself.
+  // A negative 'ulps' throws kInvalidArgument.
+  struct Tolerance {
+    enum class Mode { kAbsolute, kRelative, kUlp };
+    Mode mode = Mode::kAbsolute;
+    double epsilon = kEps;
+    std::int64_t ulps = 0;
+
+    static Tolerance Absolute(double epsilon) {
+      return {Mode::kAbsolute, epsilon, 0};
+    }
+    static Tolerance Relative(double epsilon) {
+      return {Mode::kRelative, epsilon, 0};
+    }
+    static Tolerance Ulp(std::int64_t ulps) {
+      if (ulps < 0) {
+        S21Throw(S21Status::kInvalidArgument, "Ulps must be non-negative.");
+      }
+      return {Mode::kUlp, 0, ulps};
+    }
+  };
+
+  using RowSpan = BasicRowSpan<double>;
+  using ConstRowSpan = BasicRowSpan<const double>;
+
+  // Elements are stored row-major in one block, so plain pointers are
+  // random access iterators over the whole matrix.
+  using iterator = double *;
+  using const_iterator = const double *;
+
   // Constructors and destructor
   S21Matrix();                                   // Default constructor
   S21Matrix(int rows, int cols);                 // Parametrized constructor
@@ -21,27 +129,160 @@ class S21Matrix {
   // Matrix operations
   void SumMatrix(const S21Matrix &other);
   void SubMatrix(const S21Matrix &other);
-  bool EqMatrix(const S21Matrix &other);
+  bool EqMatrix(const S21Matrix &other) const;  // Compare() within kEps
+  bool Compare(const S21Matrix &other, const Tolerance &tolerance) const;
+  // Content hash of the elements rounded to multiples of quantum, for hash
+  // tables and deduplication. Matrices whose elements round the same way
+  // hash equal; near-equal elements on both sides of a rounding boundary
+  // do not, so use a quantum of at least twice the comparison tolerance.
+  std::uint64_t QuantizedHash(double quantum = kEps) const;
   void MulNumber(const double num);
-  void MulMatrix(const S21Matrix &other);
-  S21Matrix Transpose();
-  S21Matrix CalcComplements();
-  double Determinant();
-  S21Matrix InverseMatrix();
+  void MulMatrix(const S21Matrix &other, Accuracy accuracy = Accuracy::kFast);
+  S21Matrix Transpose() const;
+  S21Matrix CalcComplements() const;
+  // Above 3x3 these go through an LU factorization that is cached together
+  // with the determinant and the inverse until the matrix is modified.
+  double Determinant() const;
+  S21Matrix InverseMatrix() const;
+  S21Matrix InverseMatrix(Precision precision) const;  // LU-based
+  S21Matrix Solve(const S21Matrix &b,
+                  Precision precision = Precision::kDouble) const;
+  S21Matrix Pow(int power) const;  // Negative powers go through the inverse
+  // Matrix exponential e^A. Throws kInvalidArgument if the matrix has an
+  // infinite or NaN element and is not diagonal.
+  S21Matrix Exp() const;
+
+  // Non-throwing API for hot paths and callers built with -fno-exceptions.
+  // Failures come back as status codes and leave the matrix unchanged; the
+  // throwing methods above are thin wrappers over these. Element blocks and
+  // factors are allocated through S21Memory::TryAllocate(), so running out
+  // of memory gives kOutOfMemory even without exceptions; with them, a
+  // failure of the small bookkeeping allocations around those is reported
+  // the same way.
+  static S21Result<S21Matrix> TryCreate(int rows, int cols) noexcept;
+  S21Status TrySumMatrix(const S21Matrix &other) noexcept;
+  S21Status TrySubMatrix(const S21Matrix &other) noexcept;
+  S21Status TryMulMatrix(const S21Matrix &other,
+                         Accuracy accuracy = Accuracy::kFast) noexcept;
+  S21Result<double> TryDeterminant() const noexcept;
+  S21Result<S21Matrix> TryInverseMatrix() const noexcept;
+  S21Result<S21Matrix> TryInverseMatrix(Precision precision) const noexcept;
+  S21Result<S21Matrix> TrySolve(
+      const S21Matrix &b,
+      Precision precision = Precision::kDouble) const noexcept;
+  double *TryAt(int row, int col) noexcept;  // Null outside the matrix
+  const double *TryAt(int row, int col) const noexcept;
+
+  // Low-rank updates
+  // this += alpha * u * v^T for a GetRows() x k matrix u and a GetCols() x k
+  // matrix v (GER when k == 1). A cached LU, inverse and determinant are
+  // carried over in O(n^2 k) rather than recomputed on the next query.
+  void RankUpdate(const S21Matrix &u, const S21Matrix &v, double alpha = 1);
+
+  // Product of the whole chain, parenthesized to minimize flops (dynamic
+  // programming over the dimensions). Only one intermediate per tree level
+  // is alive at a time; the operands are never copied.
+  static S21Matrix MultiplyChain(const std::vector<const S21Matrix *> &chain,
+                                 ChainReport *report = nullptr);
+
+  // Asynchronous operations. Operands are copied, so the caller may modify
+  // or destroy them right away; see s21_async.h for chaining futures.
+  S21Future SumMatrixAsync(const S21Matrix &other) const;
+  S21Future SubMatrixAsync(const S21Matrix &other) const;
+  S21Future MulMatrixAsync(const S21Matrix &other) const;
+  S21Future InverseMatrixAsync() const;
+  S21Future SolveAsync(const S21Matrix &b) const;
+
+  // MulMatrix spread over 'processes' forked processes in a 2D grid with
+  // SUMMA, see s21_distributed.h for the transports. Each process keeps
+  // only its blocks of the operands and the product; the workers share
+  // GetNumThreads() between them for their local products.
+  void MulMatrixDistributed(const S21Matrix &other, S21Transport &transport,
+                            int processes);
+
+  // Decompositions, see s21_decomposition.h. The count overloads return only
+  // the 'count' dominant pairs, computed by randomized subspace iteration.
+  S21EigenResult SymmetricEigen() const;  // Values in descending order
+  S21EigenResult SymmetricEigen(int count, std::uint64_t seed = 1) const;
+  S21SvdResult Svd() const;
+  S21SvdResult Svd(int count, std::uint64_t seed = 1) const;
+
+  // Convolution, see s21_convolution.cc. Elements outside the matrix count
+  // as zero; Correlate2D is Convolve2D with the kernel rotated by 180 degrees.
+  S21Matrix Convolve2D(
+      const S21Matrix &kernel, ConvolutionMode mode = ConvolutionMode::kFull,
+      ConvolutionMethod method = ConvolutionMethod::kAuto) const;
+  S21Matrix Correlate2D(
+      const S21Matrix &kernel, ConvolutionMode mode = ConvolutionMode::kFull,
+      ConvolutionMethod method = ConvolutionMethod::kAuto) const;
+
+  // Reductions
+  double Sum(Accuracy accuracy = Accuracy::kFast) const;
+  double Trace(Accuracy accuracy = Accuracy::kFast) const;
+  double FrobeniusNorm(Accuracy accuracy = Accuracy::kFast) const;
+  double Dot(const S21Matrix &other,
+             Accuracy accuracy = Accuracy::kFast) const;  // Sum of a_ij*b_ij
+  // Largest column (Norm1) or row (NormInf) sum of |a_ij|; NaN if any
+  // element is NaN.
+  double Norm1() const;
+  double NormInf() const;
+  // Largest |a_ij|, NaN when any element is NaN
+  double MaxAbs() const;
+  std::pair<int, int> ArgMax() const;  // (row, col) of the largest element
+  S21Matrix RowSums() const;           // GetRows() x 1
+  S21Matrix ColSums() const;           // 1 x GetCols()
+  S21Matrix RowMeans() const;
+  S21Matrix ColMeans() const;
+  Summary Summarize() const;
 
   // Setters and Getters
-  int GetRows();
-  int GetCols();
+  int GetRows() const;
+  int GetCols() const;
   void SetRows(int rows);
   void SetCols(int cols);
+  // Modification stamp, increasing with every change of the elements or the
+  // shape. Mutating operations and the checked accessors At() and
+  // operator() count once per call; writes through operator[], Row(),
+  // Data() or the iterators are not seen. The cached results of
+  // Determinant(), InverseMatrix() and Solve() are kept while the stamp is
+  // unchanged, so such writes need a MarkModified() call, or the next query
+  // returns the old result.
+  std::uint64_t GetVersion() const;
+  void MarkModified() { Touch(); }
+
+  // Element access
+  double &At(int row, int col);  // Bounds-checked, throws std::out_of_range
+  const double &At(int row, int col) const;
+  // The unchecked accessors are defined here so that they inline into the
+  // caller's loops, and assert by the caller's NDEBUG.
+  double *operator[](int row) {  // Unchecked row pointer, asserts in debug
+    assert(row >= 0 && row < rows_);
+    return matrix_[row];
+  }
+  const double *operator[](int row) const {
+    assert(row >= 0 && row < rows_);
+    return matrix_[row];
+  }
+  RowSpan Row(int row) { return RowSpan((*this)[row], cols_); }
+  ConstRowSpan Row(int row) const { return ConstRowSpan((*this)[row], cols_); }
+  // Row-major block of GetRows() * GetCols() elements
+  double *Data() { return matrix_ ? matrix_[0] : nullptr; }
+  const double *Data() const { return matrix_ ? matrix_[0] : nullptr; }
+  iterator begin() { return Data(); }
+  iterator end() { return Data() + Size(); }
+  const_iterator begin() const { return Data(); }
+  const_iterator end() const { return Data() + Size(); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
 
   // Operators overloads
   double &operator()(int row, int col);
-  S21Matrix operator+(const S21Matrix &other);
-  S21Matrix operator-(const S21Matrix &other);
-  S21Matrix operator*(const S21Matrix &other);
-  S21Matrix operator*(const double num);
-  bool operator==(const S21Matrix &other);
+  const double &operator()(int row, int col) const;
+  S21Matrix operator+(const S21Matrix &other) const;
+  S21Matrix operator-(const S21Matrix &other) const;
+  S21Matrix operator*(const S21Matrix &other) const;
+  S21Matrix operator*(const double num) const;
+  bool operator==(const S21Matrix &other) const;
   S21Matrix &operator+=(const S21Matrix &other);
   S21Matrix &operator-=(const S21Matrix &other);
   S21Matrix &operator*=(const S21Matrix &other);
@@ -49,18 +290,53 @@ class S21Matrix {
 
   // Additional functions
   void PrintMatrix();
-  void RandomFillMatrix();
+  void RandomFillMatrix();  // Integers 0..9 from a fresh random seed
+  void UniformFillMatrix(double low, double high, std::uint64_t seed);
+  void NormalFillMatrix(double mean, double stddev, std::uint64_t seed);
+  void IntegerFillMatrix(std::int64_t low, std::int64_t high,
+                         std::uint64_t seed);
   void NumberFillMatrix(double num);
 
  private:
   // Attributes
   int rows_, cols_;
   double **matrix_;
+  // Bumped by a relaxed load and store rather than an atomic increment:
+  // as cheap as a plain counter, and threads writing different elements
+  // through At() at once, as with std::vector, stay race-free.
+  std::atomic<std::uint64_t> version_{0};
+  // Results derived from the elements at cache_->version. Snapshots are
+  // immutable and swapped atomically, so concurrent const calls are safe.
+  struct Cache;
+  mutable std::shared_ptr<const Cache> cache_;
+
+  // Adopts 'matrix' from RowPointers().
+  S21Matrix(int rows, int cols, double **matrix) noexcept
+      : rows_(rows), cols_(cols), matrix_(matrix) {}
 
   // Additional private functions
+  static double **RowPointers(double *block, int rows, int cols) noexcept;
   void MemoryAllocation();
-  bool CheckSizeMatrix(const S21Matrix &other);
-  void MinorMatrix(int row, int col, S21Matrix &smaller);
+  void MemoryFree();
+  std::size_t Size() const {
+    return static_cast<std::size_t>(rows_) * static_cast<std::size_t>(cols_);
+  }
+  bool CheckSizeMatrix(const S21Matrix &other) const;
+  void MinorMatrix(int row, int col, S21Matrix &smaller) const;
+  void Touch() {
+    version_.store(version_.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+  }
+  Cache CurrentCache() const;
+  void Publish(Cache cache) const;
+  S21Result<Cache> FactoredCache() const;
+  S21Result<S21Matrix> TryCopy() const noexcept;
+  S21Status StreamMulMatrix(const S21Matrix &other, Accuracy accuracy);
+  Cache UpdatedCache(const Cache &cache, const S21Matrix &u,
+                     const S21Matrix &vt) const;
+  bool RefineSolution(const S21Matrix &b, S21Matrix &x) const;
+  bool IsDiagonal() const;
+  static S21Matrix Identity(int size);
 };
 
 #endif  // CPP1_S21_MATRIXPLUS_S21_MATRIX_OOP_H
@@ -0,0 +1,300 @@
+#include "s21_memory.h"
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <string>
+
+#include "s21_parallel.h"
+#include "s21_status.h"
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const std::size_t kHugePage = std::size_t(2) << 20;
+
+enum class Origin : std::uint32_t { kHeap, kMapped };
+
+// Usage of one thread. The thread holds a reference until it exits, and
+// every live block it allocated holds one more, so frees from other
+// threads after it is gone still land somewhere.
+struct Account {
+  std::atomic<std::size_t> current{0};
+  std::atomic<std::size_t> peak{0};
+  std::atomic<std::size_t> references{1};
+};
+
+void Release(Account *account) {
+  if (account->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete account;
+  }
+}
+
+struct ThreadAccount {
+  Account *account = new Account;
+  ~ThreadAccount() { Release(account); }
+};
+
+Account &CurrentAccount() {
+  thread_local ThreadAccount owner;
+  return *owner.account;
+}
+
+std::atomic<std::size_t> total_current{0};
+std::atomic<std::size_t> total_peak{0};
+
+void RaisePeak(std::atomic<std::size_t> &peak, std::size_t value) {
+  std::size_t seen = peak.load(std::memory_order_relaxed);
+  while (value > seen &&
+         !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {
+  }
+}
+
+// Adds bytes to the totals and to the calling thread. Over the limit the
+// charge is taken back and null returned; concurrent allocations near the
+// limit may then fail too, never exceed it.
+Account *Charge(std::size_t bytes) noexcept {
+  std::size_t limit = S21Memory::GetLimit();
+  std::size_t total =
+      total_current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  if (limit != 0 && total > limit) {
+    total_current.fetch_sub(bytes, std::memory_order_relaxed);
+    return nullptr;
+  }
+  RaisePeak(total_peak, total);
+  Account &account = CurrentAccount();
+  account.references.fetch_add(1, std::memory_order_relaxed);
+  std::size_t own =
+      account.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  RaisePeak(account.peak, own);
+  return &account;
+}
+
+void Uncharge(Account *account, std::size_t bytes) {
+  total_current.fetch_sub(bytes, std::memory_order_relaxed);
+  account->current.fetch_sub(bytes, std::memory_order_relaxed);
+  Release(account);
+}
+
+// Stored in the kAlignment bytes in front of every block.
+struct Header {
+  Origin origin;
+  std::size_t bytes;  // Including the header
+  void *base;         // Start of the underlying allocation
+  Account *account;   // Charged for the block
+};
+
+static_assert(sizeof(Header) <= S21Memory::kAlignment,
+              "Block header must fit in the alignment padding.");
+
+Header *HeaderOf(void *data) {
+  return reinterpret_cast<Header *>(static_cast<char *>(data) -
+                                    S21Memory::kAlignment);
+}
+
+#ifdef __linux__
+// Maps bytes aligned to a huge page boundary, trimming the slack. Null
+// when the kernel refuses.
+void *MapAligned(std::size_t bytes) {
+  std::size_t padded = bytes + kHugePage;
+  void *raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED) return nullptr;
+  auto start = reinterpret_cast<std::uintptr_t>(raw);
+  auto aligned = (start + kHugePage - 1) & ~(kHugePage - 1);
+  if (aligned > start) munmap(raw, aligned - start);
+  std::size_t tail = padded - (aligned - start) - bytes;
+  if (tail > 0) munmap(reinterpret_cast<void *>(aligned + bytes), tail);
+  return reinterpret_cast<void *>(aligned);
+}
+
+void Interleave(void *base, std::size_t bytes) {
+  int nodes = S21Parallel::GetNumaNodes();
+  if (nodes < 2) return;
+  unsigned long mask[16] = {0};
+  for (int node = 0; node < nodes && node < 16 * 64; ++node) {
+    mask[node / 64] |= 1ul << (node % 64);
+  }
+  // Best effort: placement is only a hint for performance.
+  syscall(SYS_mbind, base, bytes, MPOL_INTERLEAVE, mask, 16 * 64, 0);
+}
+#endif
+
+// Charges and places a heap block of header.bytes bytes, the header
+// included.
+S21Result<char *> HeapBlock(Header &header) noexcept {
+  header.account = Charge(header.bytes);
+  if (header.account == nullptr) return S21Status::kMemoryLimit;
+  char *base = static_cast<char *>(::operator new(
+      header.bytes, std::align_val_t(S21Memory::kAlignment), std::nothrow));
+  if (base == nullptr) {
+    Uncharge(header.account, header.bytes);
+    return S21Status::kOutOfMemory;
+  }
+  header.base = base;
+  std::memcpy(base, &header, sizeof(header));
+  return base + S21Memory::kAlignment;
+}
+
+// Allocations the calling thread has left before they fail, or -1.
+thread_local int failure_countdown = -1;
+
+bool InjectedFailure() noexcept {
+  if (failure_countdown < 0) return false;
+  if (failure_countdown == 0) return true;
+  --failure_countdown;
+  return false;
+}
+
+// Raises the exception of a failed allocation of 'bytes' bytes.
+[[noreturn]] void AllocationFailed(S21Status status, std::size_t bytes) {
+  if (status != S21Status::kMemoryLimit) S21Throw(status);
+  std::string message = "Allocating " + std::to_string(bytes) +
+                        " bytes would exceed the memory limit of " +
+                        std::to_string(S21Memory::GetLimit()) + " bytes, " +
+                        std::to_string(total_current.load()) +
+                        " being in use.";
+  S21Throw(status, message.c_str());
+}
+
+}  // namespace
+
+std::atomic<std::size_t> S21Memory::large_threshold_{std::size_t(4) << 20};
+std::atomic<S21Memory::Placement> S21Memory::placement_{
+    Placement::kFirstTouch};
+std::atomic<std::size_t> S21Memory::limit_{0};
+
+double *S21Memory::Allocate(int rows, int cols) {
+  S21Result<double *> data = TryAllocate(rows, cols);
+  if (!data) AllocationFailed(data.GetStatus(), BlockBytes(rows, cols));
+  return *data;
+}
+
+S21Result<double *> S21Memory::TryAllocate(int rows, int cols) noexcept {
+  if (InjectedFailure()) return S21Status::kOutOfMemory;
+  std::size_t row_bytes = static_cast<std::size_t>(cols) * sizeof(double);
+  std::size_t bytes = BlockBytes(rows, cols);
+  Header header{Origin::kHeap, bytes, nullptr, nullptr};
+#ifdef __linux__
+  if (bytes >= GetLargeThreshold()) header.origin = Origin::kMapped;
+#endif
+  if (header.origin == Origin::kHeap) {
+    S21Result<char *> data = HeapBlock(header);
+    if (!data) return data.GetStatus();
+    std::memset(*data, 0, bytes - kAlignment);
+    return reinterpret_cast<double *>(*data);
+  }
+  char *base = nullptr;
+#ifdef __linux__
+  header.account = Charge(bytes);
+  if (header.account == nullptr) return S21Status::kMemoryLimit;
+  base = static_cast<char *>(MapAligned(bytes));
+  if (base == nullptr) {
+    Uncharge(header.account, bytes);
+    return S21Status::kOutOfMemory;
+  }
+  madvise(base, bytes, MADV_HUGEPAGE);
+  if (GetPlacement() == Placement::kInterleave) Interleave(base, bytes);
+  // Fresh pages are already zero; writing them places each page on the
+  // node of the worker that owns its rows. Without workers the block is
+  // only placed less well.
+  S21_TRY {
+    S21Parallel::For(0, rows, 1, [&](std::size_t first, std::size_t last) {
+      std::memset(base + kAlignment + first * row_bytes, 0,
+                  (last - first) * row_bytes);
+    });
+  }
+  S21_CATCH_ALL {}
+  header.base = base;
+  std::memcpy(base, &header, sizeof(header));
+#endif
+  return reinterpret_cast<double *>(base + kAlignment);
+}
+
+void S21Memory::Free(double *data) { FreeBytes(data); }
+
+void *S21Memory::AllocateBytes(std::size_t bytes) {
+  S21Result<void *> data = TryAllocateBytes(bytes);
+  if (!data) AllocationFailed(data.GetStatus(), kAlignment + bytes);
+  return *data;
+}
+
+S21Result<void *> S21Memory::TryAllocateBytes(std::size_t bytes) noexcept {
+  if (InjectedFailure()) return S21Status::kOutOfMemory;
+  Header header{Origin::kHeap, kAlignment + bytes, nullptr, nullptr};
+  S21Result<char *> data = HeapBlock(header);
+  if (!data) return data.GetStatus();
+  return static_cast<void *>(*data);
+}
+
+void S21Memory::FreeBytes(void *data) {
+  if (data == nullptr) return;
+  Header header;
+  std::memcpy(&header, HeaderOf(data), sizeof(header));
+  if (header.origin == Origin::kHeap) {
+    ::operator delete(header.base, std::align_val_t(kAlignment));
+  } else {
+#ifdef __linux__
+    munmap(header.base, header.bytes);
+#endif
+  }
+  Uncharge(header.account, header.bytes);
+}
+
+std::size_t S21Memory::BlockBytes(int rows, int cols) {
+  return kAlignment + static_cast<std::size_t>(rows) * cols * sizeof(double);
+}
+
+S21Memory::Usage S21Memory::GetUsage() {
+  return {total_current.load(), total_peak.load()};
+}
+
+S21Memory::Usage S21Memory::GetThreadUsage() {
+  Account &account = CurrentAccount();
+  return {account.current.load(), account.peak.load()};
+}
+
+void S21Memory::ResetPeak() {
+  total_peak.store(total_current.load());
+  Account &account = CurrentAccount();
+  account.peak.store(account.current.load());
+}
+
+std::size_t S21Memory::GetLimit() {
+  return limit_.load(std::memory_order_relaxed);
+}
+
+void S21Memory::SetLimit(std::size_t bytes) {
+  limit_.store(bytes, std::memory_order_relaxed);
+}
+
+void S21Memory::FailAfter(int allocations) {
+  failure_countdown = allocations < 0 ? -1 : allocations;
+}
+
+bool S21Memory::Fits(std::size_t bytes) {
+  std::size_t limit = GetLimit();
+  return limit == 0 || total_current.load() + bytes <= limit;
+}
+
+std::size_t S21Memory::GetLargeThreshold() {
+  return large_threshold_.load(std::memory_order_relaxed);
+}
+
+void S21Memory::SetLargeThreshold(std::size_t bytes) {
+  large_threshold_.store(bytes, std::memory_order_relaxed);
+}
+
+S21Memory::Placement S21Memory::GetPlacement() {
+  return placement_.load(std::memory_order_relaxed);
+}
+
+void S21Memory::SetPlacement(Placement placement) {
+  placement_.store(placement, std::memory_order_relaxed);
+}
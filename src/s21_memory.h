@@ -0,0 +1,128 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_MEMORY_H
+#define CPP1_S21_MATRIXPLUS_S21_MEMORY_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include "s21_status.h"
+
+// Allocation of matrix element blocks. Blocks of at least
+// GetLargeThreshold() bytes are mapped straight from the kernel, backed by
+// transparent huge pages, and zeroed in parallel with the row partition the
+// kernels use, so on NUMA hosts each page lands on the node of the thread
+// that later works on those rows. Smaller blocks come from the heap.
+//
+// Every block is accounted, headers included: matrix elements and the
+// scratch buffers held in an S21Buffer, such as LU factors.
+class S21Memory {
+ public:
+  // Page placement of large blocks: on the node of the first writer, or
+  // round-robin over all nodes.
+  enum class Placement { kFirstTouch, kInterleave };
+
+  struct Usage {
+    std::size_t current = 0;  // Bytes in blocks not yet freed
+    std::size_t peak = 0;     // Most at any time since the last ResetPeak()
+  };
+
+  static const std::size_t kAlignment = 64;  // Bytes, for SIMD loads
+
+  // Zero-initialized block of rows * cols doubles.
+  static double *Allocate(int rows, int cols);
+  static void Free(double *data);
+  // Uninitialized block of at least 'bytes' bytes, aligned to kAlignment.
+  static void *AllocateBytes(std::size_t bytes);
+  static void FreeBytes(void *data);
+  // As above, failing with kOutOfMemory or kMemoryLimit rather than
+  // throwing, also when built with -fno-exceptions.
+  static S21Result<double *> TryAllocate(int rows, int cols) noexcept;
+  static S21Result<void *> TryAllocateBytes(std::size_t bytes) noexcept;
+  // Bytes a rows x cols block takes, as charged by Allocate().
+  static std::size_t BlockBytes(int rows, int cols);
+
+  // All threads together, and the calling thread, which is charged for
+  // the blocks it allocated until they are freed, by whichever thread.
+  static Usage GetUsage();
+  static Usage GetThreadUsage();
+  // Restarts the overall peak and that of the calling thread from their
+  // current values.
+  static void ResetPeak();
+
+  // Low-memory mode. With a limit set, an allocation that would take the
+  // total past it fails with S21Status::kMemoryLimit before anything is
+  // allocated. Operations that need several blocks check their whole
+  // footprint up front, and switch to algorithms that need less: products
+  // by a square matrix stream row tiles back into place, inverses run
+  // Gauss-Jordan in place in the result, and factorizations are dropped
+  // after use rather than cached. 0, the default, means no limit.
+  static std::size_t GetLimit();
+  static void SetLimit(std::size_t bytes);
+  static bool IsLowMemory() { return GetLimit() != 0; }
+  // Whether 'bytes' more fit under the limit right now.
+  static bool Fits(std::size_t bytes);
+
+  // Fault injection for tests: once 'allocations' more have succeeded, every
+  // allocation of the calling thread fails as out of memory. A negative
+  // count, the default, turns it off.
+  static void FailAfter(int allocations);
+
+  static std::size_t GetLargeThreshold();
+  static void SetLargeThreshold(std::size_t bytes);
+  static Placement GetPlacement();
+  static void SetPlacement(Placement placement);
+
+ private:
+  static std::atomic<std::size_t> large_threshold_;
+  static std::atomic<Placement> placement_;
+  static std::atomic<std::size_t> limit_;
+};
+
+// Scratch array of trivially copyable T in a block of S21Memory, so that it
+// counts towards the usage and the limit. Resize() reports a failed
+// allocation as a status; copies allocate through the throwing path.
+template <typename T>
+class S21Buffer {
+ public:
+  S21Buffer() = default;
+  S21Buffer(const S21Buffer &other) {
+    if (other.size_ == 0) return;
+    data_ = static_cast<T *>(S21Memory::AllocateBytes(other.size_ * sizeof(T)));
+    size_ = other.size_;
+    std::copy(other.data_, other.data_ + size_, data_);
+  }
+  S21Buffer &operator=(S21Buffer other) noexcept {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    return *this;
+  }
+  ~S21Buffer() { S21Memory::FreeBytes(data_); }
+
+  // Makes room for 'size' elements, discarding the contents. On failure
+  // the buffer is left empty.
+  S21Status Resize(std::size_t size) noexcept {
+    if (size == size_) return S21Status::kOk;
+    S21Memory::FreeBytes(data_);
+    data_ = nullptr;
+    size_ = 0;
+    if (size == 0) return S21Status::kOk;
+    S21Result<void *> block = S21Memory::TryAllocateBytes(size * sizeof(T));
+    if (!block) return block.GetStatus();
+    data_ = static_cast<T *>(*block);
+    size_ = size;
+    return S21Status::kOk;
+  }
+
+  T *data() { return data_; }
+  const T *data() const { return data_; }
+  std::size_t size() const { return size_; }
+  T &operator[](std::size_t index) { return data_[index]; }
+  const T &operator[](std::size_t index) const { return data_[index]; }
+
+ private:
+  T *data_ = nullptr;
+  std::size_t size_ = 0;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_MEMORY_H
@@ -0,0 +1,271 @@
+#include "s21_parallel.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "s21_status.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+thread_local bool in_parallel_region = false;
+
+int HardwareThreads() {
+  unsigned threads = std::thread::hardware_concurrency();
+  return threads == 0 ? 1 : static_cast<int>(threads);
+}
+
+// Parses a sysfs CPU list such as "0-3,8-11".
+std::vector<int> ParseCpuList(const std::string &list) {
+  std::vector<int> cpus;
+  std::stringstream stream(list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    if (range.empty()) continue;
+    std::size_t dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = dash == std::string::npos ? first
+                                         : std::stoi(range.substr(dash + 1));
+    for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+// Binds the calling thread to one CPU, or with cpu < 0 gives it back the
+// CPUs of 'allowed'. Workers call it themselves before touching any data,
+// so first-touch placement happens on the node of their CPU.
+#ifdef __linux__
+void PinCurrentThread(int cpu, const cpu_set_t &allowed) {
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (cpu >= 0) CPU_SET(cpu, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set),
+                         cpu >= 0 ? &set : &allowed);
+}
+#endif
+
+// Workers kept from one For() to the next, parked on a condition variable
+// between jobs, so a call costs a wake-up rather than a thread start.
+// Pool worker w runs chunk first + w of every job it takes part in. The
+// workers are stopped around fork(), which then copies a single-threaded
+// process, and started again by the next job on either side.
+class Pool {
+ public:
+  Pool() {
+#ifdef __linux__
+    CPU_ZERO(&allowed_);
+    sched_getaffinity(0, sizeof(allowed_), &allowed_);
+    pthread_atfork([] { Get().Stop(); }, [] { Get().busy_.unlock(); },
+                   [] { Get().busy_.unlock(); });
+#endif
+  }
+
+  // Never destroyed, so that no worker outlives the pool at exit.
+  static Pool &Get() {
+    static Pool *pool = new Pool;
+    return *pool;
+  }
+
+  // One job at a time; callers that find the pool busy run inline.
+  std::mutex &Busy() { return busy_; }
+
+  // Runs run(chunk) for chunks [first, chunks) on the workers and, when
+  // first is 1, chunk 0 on the caller meanwhile; returns once all are done.
+  // cpus, when not empty, gives the CPU of each chunk.
+  void Run(std::size_t first, std::size_t chunks, const std::vector<int> &cpus,
+           const std::function<void(std::size_t)> &run) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (threads_.size() < chunks - first) {
+      std::size_t index = threads_.size();
+      threads_.emplace_back([this, index] { Work(index); });
+    }
+    run_ = &run;
+    first_ = first;
+    chunks_ = chunks;
+    cpus_ = &cpus;
+    pending_ = chunks - first;
+    ++generation_;
+    wake_.notify_all();
+    if (first == 1) {
+      lock.unlock();
+      run(0);
+      lock.lock();
+    }
+    done_.wait(lock, [this] { return pending_ == 0; });
+    run_ = nullptr;
+  }
+
+ private:
+  // Waits for the running job, then joins the workers. Leaves busy_ locked
+  // until the fork handlers release it.
+  void Stop() {
+    busy_.lock();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+      ++generation_;
+    }
+    wake_.notify_all();
+    for (std::thread &thread : threads_) thread.join();
+    threads_.clear();
+    stop_ = false;
+  }
+
+  void Work(std::size_t index) {
+    std::uint64_t seen = 0;
+    int pinned = -1;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      wake_.wait(lock, [&] { return generation_ != seen; });
+      seen = generation_;
+      if (stop_) return;
+      std::size_t chunk = first_ + index;
+      if (run_ == nullptr || chunk >= chunks_) continue;
+      int cpu = cpus_->empty() ? -1 : (*cpus_)[chunk];
+      const std::function<void(std::size_t)> &run = *run_;
+      lock.unlock();
+#ifdef __linux__
+      if (cpu != pinned) PinCurrentThread(cpu, allowed_);
+#endif
+      pinned = cpu;
+      run(chunk);
+      lock.lock();
+      if (--pending_ == 0) done_.notify_one();
+    }
+  }
+
+  std::mutex busy_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+  std::vector<std::thread> threads_;
+  bool stop_ = false;
+  std::uint64_t generation_ = 0;
+  const std::function<void(std::size_t)> *run_ = nullptr;
+  std::size_t first_ = 0;
+  std::size_t chunks_ = 0;
+  const std::vector<int> *cpus_ = nullptr;
+  std::size_t pending_ = 0;
+#ifdef __linux__
+  cpu_set_t allowed_;
+#endif
+};
+
+}  // namespace
+
+std::atomic<int> S21Parallel::num_threads_{0};
+std::atomic<bool> S21Parallel::pinning_{false};
+
+int S21Parallel::GetNumThreads() {
+  int threads = num_threads_.load(std::memory_order_relaxed);
+  return threads > 0 ? threads : HardwareThreads();
+}
+
+void S21Parallel::SetNumThreads(int threads) {
+  num_threads_.store(threads > 0 ? threads : 0, std::memory_order_relaxed);
+}
+
+bool S21Parallel::GetThreadPinning() {
+  return pinning_.load(std::memory_order_relaxed);
+}
+
+void S21Parallel::SetThreadPinning(bool enabled) {
+  pinning_.store(enabled, std::memory_order_relaxed);
+}
+
+int S21Parallel::GetNumaNodes() { return static_cast<int>(Topology().size()); }
+
+const std::vector<std::vector<int>> &S21Parallel::Topology() {
+  static const std::vector<std::vector<int>> topology = [] {
+    std::vector<std::vector<int>> nodes;
+#ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    bool have_mask = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+    for (int node = 0;; ++node) {
+      std::ifstream file("/sys/devices/system/node/node" +
+                         std::to_string(node) + "/cpulist");
+      if (!file) break;
+      std::string list;
+      std::getline(file, list);
+      std::vector<int> cpus;
+      for (int cpu : ParseCpuList(list)) {
+        if (!have_mask || CPU_ISSET(cpu, &allowed)) cpus.push_back(cpu);
+      }
+      if (!cpus.empty()) nodes.push_back(cpus);
+    }
+#endif
+    if (nodes.empty()) {
+      nodes.emplace_back();
+      for (int cpu = 0; cpu < HardwareThreads(); ++cpu) {
+        nodes[0].push_back(cpu);
+      }
+    }
+    return nodes;
+  }();
+  return topology;
+}
+
+void S21Parallel::For(
+    std::size_t begin, std::size_t end, std::size_t grain,
+    const std::function<void(std::size_t, std::size_t)> &body) {
+  if (begin >= end) return;
+  std::size_t length = end - begin;
+  grain = std::max<std::size_t>(grain, 1);
+  std::size_t chunks = std::min<std::size_t>(
+      static_cast<std::size_t>(GetNumThreads()), (length + grain - 1) / grain);
+  if (chunks <= 1 || in_parallel_region) {
+    body(begin, end);
+    return;
+  }
+
+  Pool &pool = Pool::Get();
+  std::unique_lock<std::mutex> busy(pool.Busy(), std::try_to_lock);
+  if (!busy) {
+    body(begin, end);
+    return;
+  }
+
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  std::function<void(std::size_t)> run_chunk = [&](std::size_t chunk) {
+    std::size_t chunk_begin = begin + length * chunk / chunks;
+    std::size_t chunk_end = begin + length * (chunk + 1) / chunks;
+    in_parallel_region = true;
+    S21_TRY { body(chunk_begin, chunk_end); }
+    S21_CATCH_ALL {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error) error = std::current_exception();
+    }
+    in_parallel_region = false;
+  };
+
+  std::vector<int> chunk_cpus;
+  if (GetThreadPinning()) {
+    // Spread the chunks evenly over the CPUs in node order, so neighbouring
+    // chunks share a node.
+    std::vector<int> cpus;
+    for (const std::vector<int> &node : Topology()) {
+      cpus.insert(cpus.end(), node.begin(), node.end());
+    }
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+      chunk_cpus.push_back(cpus[chunk * cpus.size() / chunks]);
+    }
+    pool.Run(0, chunks, chunk_cpus, run_chunk);
+  } else {
+    // The caller takes chunk 0 while the workers run the rest.
+    pool.Run(1, chunks, chunk_cpus, run_chunk);
+  }
+  if (error) std::rethrow_exception(error);
+}
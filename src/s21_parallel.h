@@ -0,0 +1,43 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_PARALLEL_H
+#define CPP1_S21_MATRIXPLUS_S21_PARALLEL_H
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// Fork-join helper used by the matrix kernels. Work is split into contiguous
+// chunks, and chunk t of a range always goes to worker t, so a partition is
+// reproducible from one call to the next. Workers persist between calls,
+// parked until the next one. With thread pinning on, worker t is bound to
+// a fixed CPU, CPUs being taken node by node, so the rows a worker first
+// touched stay on its NUMA node in later calls.
+class S21Parallel {
+ public:
+  // Number of threads used by For(). Defaults to the hardware concurrency;
+  // SetNumThreads with a value below 1 restores the default.
+  static int GetNumThreads();
+  static void SetNumThreads(int threads);
+  static bool GetThreadPinning();
+  static void SetThreadPinning(bool enabled);
+  static int GetNumaNodes();
+
+  // Runs body(chunk_begin, chunk_end) over [begin, end) split into at most
+  // GetNumThreads() chunks of at least grain elements. Short ranges, calls
+  // made from inside another For() and calls from other threads while the
+  // workers are busy run inline on the calling thread. The first exception
+  // thrown by a chunk is rethrown to the caller. With pinning on, every
+  // chunk runs on a pinned worker and the caller only waits, so its own
+  // affinity is left alone.
+  static void For(std::size_t begin, std::size_t end, std::size_t grain,
+                  const std::function<void(std::size_t, std::size_t)> &body);
+
+ private:
+  // CPUs available to the process, grouped by NUMA node.
+  static const std::vector<std::vector<int>> &Topology();
+
+  static std::atomic<int> num_threads_;
+  static std::atomic<bool> pinning_;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_PARALLEL_H
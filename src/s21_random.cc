@@ -0,0 +1,150 @@
+#include "s21_random.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "s21_parallel.h"
+#include "s21_status.h"
+
+namespace {
+
+const std::uint32_t kMul0 = 0xD2511F53u;
+const std::uint32_t kMul1 = 0xCD9E8D57u;
+const std::uint32_t kWeyl0 = 0x9E3779B9u;
+const std::uint32_t kWeyl1 = 0xBB67AE85u;
+const int kRounds = 10;
+
+// Each Philox block yields two 64-bit words, i.e. two matrix elements.
+const std::size_t kElementsPerBlock = 2;
+const std::size_t kGrainBlocks = 1 << 14;
+
+inline std::uint64_t Word64(const std::uint32_t *block, int half) {
+  return (static_cast<std::uint64_t>(block[2 * half]) << 32) |
+         block[2 * half + 1];
+}
+
+// 53 random bits mapped to [0, 1).
+inline double ToUnit(std::uint64_t word) {
+  return static_cast<double>(word >> 11) * 0x1.0p-53;
+}
+
+// Generates the blocks covering elements [0, size) in parallel and hands
+// each block with its first element index to emit(block, element, count).
+template <typename Emit>
+void ForEachBlock(std::size_t size, std::uint64_t seed, Emit emit) {
+  S21Philox philox(seed);
+  std::size_t blocks = (size + kElementsPerBlock - 1) / kElementsPerBlock;
+  S21Parallel::For(0, blocks, kGrainBlocks, [&](std::size_t first,
+                                                std::size_t last) {
+    std::uint32_t words[S21Philox::kBatch * S21Philox::kWordsPerBlock];
+    for (std::size_t b = first; b < last; b += S21Philox::kBatch) {
+      std::size_t count = std::min<std::size_t>(S21Philox::kBatch, last - b);
+      philox.Blocks(b, count, words);
+      for (std::size_t k = 0; k < count; ++k) {
+        std::size_t element = (b + k) * kElementsPerBlock;
+        std::size_t left = std::min(kElementsPerBlock, size - element);
+        emit(words + k * S21Philox::kWordsPerBlock, element, left);
+      }
+    }
+  });
+}
+
+}  // namespace
+
+S21Philox::S21Philox(std::uint64_t seed)
+    : key_{static_cast<std::uint32_t>(seed),
+           static_cast<std::uint32_t>(seed >> 32)} {}
+
+void S21Philox::Block(std::uint64_t counter, std::uint32_t *out) const {
+  Blocks(counter, 1, out);
+}
+
+void S21Philox::Blocks(std::uint64_t first, std::size_t count,
+                       std::uint32_t *out) const {
+  for (std::size_t start = 0; start < count; start += kBatch) {
+    std::uint32_t c0[kBatch], c1[kBatch], c2[kBatch], c3[kBatch];
+    for (int lane = 0; lane < kBatch; ++lane) {
+      std::uint64_t counter = first + start + lane;
+      c0[lane] = static_cast<std::uint32_t>(counter);
+      c1[lane] = static_cast<std::uint32_t>(counter >> 32);
+      c2[lane] = 0;
+      c3[lane] = 0;
+    }
+    std::uint32_t k0 = key_[0], k1 = key_[1];
+    for (int round = 0; round < kRounds; ++round) {
+      for (int lane = 0; lane < kBatch; ++lane) {
+        std::uint64_t p0 = static_cast<std::uint64_t>(kMul0) * c0[lane];
+        std::uint64_t p1 = static_cast<std::uint64_t>(kMul1) * c2[lane];
+        std::uint32_t n0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1[lane] ^ k0;
+        std::uint32_t n2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3[lane] ^ k1;
+        c1[lane] = static_cast<std::uint32_t>(p1);
+        c3[lane] = static_cast<std::uint32_t>(p0);
+        c0[lane] = n0;
+        c2[lane] = n2;
+      }
+      k0 += kWeyl0;
+      k1 += kWeyl1;
+    }
+    std::size_t lanes = std::min<std::size_t>(kBatch, count - start);
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+      std::uint32_t *block = out + (start + lane) * kWordsPerBlock;
+      block[0] = c0[lane];
+      block[1] = c1[lane];
+      block[2] = c2[lane];
+      block[3] = c3[lane];
+    }
+  }
+}
+
+void S21Random::FillUniform(double *data, std::size_t size, double low,
+                            double high, std::uint64_t seed) {
+  if (!(low < high)) {
+    S21Throw(S21Status::kInvalidArgument,
+             "Uniform range must satisfy low < high.");
+  }
+  double width = high - low;
+  ForEachBlock(size, seed, [&](const std::uint32_t *block, std::size_t element,
+                               std::size_t count) {
+    for (std::size_t h = 0; h < count; ++h) {
+      data[element + h] = low + width * ToUnit(Word64(block, h));
+    }
+  });
+}
+
+void S21Random::FillNormal(double *data, std::size_t size, double mean,
+                           double stddev, std::uint64_t seed) {
+  if (stddev < 0) {
+    S21Throw(S21Status::kInvalidArgument,
+             "Standard deviation must not be negative.");
+  }
+  const double kTwoPi = 6.283185307179586;
+  ForEachBlock(size, seed, [&](const std::uint32_t *block, std::size_t element,
+                               std::size_t count) {
+    double radius = std::sqrt(-2.0 * std::log(1.0 - ToUnit(Word64(block, 0))));
+    double angle = kTwoPi * ToUnit(Word64(block, 1));
+    data[element] = mean + stddev * radius * std::cos(angle);
+    if (count > 1) data[element + 1] = mean + stddev * radius * std::sin(angle);
+  });
+}
+
+void S21Random::FillInteger(double *data, std::size_t size, std::int64_t low,
+                            std::int64_t high, std::uint64_t seed) {
+  if (low > high) {
+    S21Throw(S21Status::kInvalidArgument,
+             "Integer range must satisfy low <= high.");
+  }
+  // Multiply-shift range reduction; span is at most 2^64 here.
+  unsigned __int128 span = static_cast<unsigned __int128>(
+                               static_cast<std::uint64_t>(high) -
+                               static_cast<std::uint64_t>(low)) +
+                           1;
+  ForEachBlock(size, seed, [&](const std::uint32_t *block, std::size_t element,
+                               std::size_t count) {
+    for (std::size_t h = 0; h < count; ++h) {
+      std::uint64_t offset =
+          static_cast<std::uint64_t>((Word64(block, h) * span) >> 64);
+      data[element + h] = static_cast<double>(static_cast<std::int64_t>(
+          static_cast<std::uint64_t>(low) + offset));
+    }
+  });
+}
@@ -0,0 +1,43 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_RANDOM_H
+#define CPP1_S21_MATRIXPLUS_S21_RANDOM_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Counter-based Philox4x32-10 generator. Block n is a pure function of the
+// seed and n, so any slice of a random sequence can be produced on its own
+// and a parallel fill gives the same numbers for every thread count.
+class S21Philox {
+ public:
+  static const int kWordsPerBlock = 4;
+  static const int kBatch = 16;  // Blocks generated side by side in Blocks()
+
+  explicit S21Philox(std::uint64_t seed);
+
+  // Writes the four words of block 'counter' to out.
+  void Block(std::uint64_t counter, std::uint32_t *out) const;
+  // Writes blocks [first, first + count) to out, kWordsPerBlock words each.
+  // Blocks are computed kBatch at a time in struct-of-arrays form so the
+  // rounds compile to SIMD multiplies.
+  void Blocks(std::uint64_t first, std::size_t count, std::uint32_t *out) const;
+
+ private:
+  std::uint32_t key_[2];
+};
+
+// Parallel fills of a flat array. Element i always receives the same value
+// for a given seed, regardless of S21Parallel::GetNumThreads().
+class S21Random {
+ public:
+  // Uniform doubles in [low, high).
+  static void FillUniform(double *data, std::size_t size, double low,
+                          double high, std::uint64_t seed);
+  // Normally distributed doubles (Box-Muller).
+  static void FillNormal(double *data, std::size_t size, double mean,
+                         double stddev, std::uint64_t seed);
+  // Integers in [low, high] stored as doubles.
+  static void FillInteger(double *data, std::size_t size, std::int64_t low,
+                          std::int64_t high, std::uint64_t seed);
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_RANDOM_H
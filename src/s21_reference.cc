@@ -0,0 +1,280 @@
+#include "s21_reference.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#include "s21_status.h"
+
+namespace {
+
+// Unit roundoff of double, and the headroom the checks give the
+// first-order error bounds.
+const double kUnit = std::numeric_limits<double>::epsilon() / 2;
+const double kSlack = 4;
+
+void CheckExpandable(const S21Matrix &a) {
+  if (a.GetRows() != a.GetCols()) S21Throw(S21Status::kNotSquare);
+  if (a.GetRows() > S21Reference::kMaxCofactorSize) {
+    S21Throw(S21Status::kInvalidArgument,
+             "The matrix is too large for the cofactor expansion.");
+  }
+}
+
+// Laplace expansion of the n x n row-major block a along its rows.
+// minor[s] is the determinant of the last n - |s| rows on the columns
+// outside s, so each one is expanded once however many paths lead to it.
+double Expand(const double *a, int n) {
+  const unsigned full = (1u << n) - 1;
+  std::vector<double> minor(full + 1);
+  minor[full] = 1;
+  for (unsigned s = full; s-- > 0;) {
+    const double *row = a + std::bitset<32>(s).count() * n;
+    double determinant = 0;
+    double sign = 1;
+    for (int j = 0; j < n; ++j) {
+      if (s & (1u << j)) continue;
+      determinant += sign * row[j] * minor[s | (1u << j)];
+      sign = -sign;
+    }
+    minor[s] = determinant;
+  }
+  return minor[0];
+}
+
+// a without row 'row' and column 'col', row-major.
+std::vector<double> Minor(const S21Matrix &a, int row, int col) {
+  std::vector<double> minor;
+  minor.reserve(static_cast<std::size_t>(a.GetRows() - 1) *
+                (a.GetCols() - 1));
+  for (int i = 0; i < a.GetRows(); ++i) {
+    if (i == row) continue;
+    for (int j = 0; j < a.GetCols(); ++j) {
+      if (j != col) minor.push_back(a(i, j));
+    }
+  }
+  return minor;
+}
+
+S21Matrix Abs(const S21Matrix &a) {
+  S21Matrix result(a.GetRows(), a.GetCols());
+  std::transform(a.begin(), a.end(), result.begin(),
+                 [](double value) { return std::fabs(value); });
+  return result;
+}
+
+// Product of the row sums of |a|. It bounds the permanent of |a|, and so
+// every partial sum of the expansion.
+double RowNormProduct(const S21Matrix &a) {
+  S21Matrix sums = Abs(a).RowSums();
+  double product = 1;
+  for (double sum : sums) product *= sum;
+  return product;
+}
+
+std::string StatusMismatch(const char *path, S21Status status,
+                           S21Status expected) {
+  if (status == expected) return "";
+  std::ostringstream out;
+  out << path << ": status \"" << S21StatusMessage(status)
+      << "\", expected \"" << S21StatusMessage(expected) << "\"";
+  return out.str();
+}
+
+std::string ValueMismatch(const char *path, int row, int col, double value,
+                          double expected, double bound) {
+  std::ostringstream out;
+  out.precision(17);
+  out << path << ": element (" << row << ", " << col << ") is " << value
+      << ", reference " << expected << ", allowed error " << bound;
+  return out.str();
+}
+
+// First element of value further than bound(i, j) from expected; NaN is
+// never close to anything.
+std::string Mismatch(const char *path, const S21Matrix &value,
+                     const S21Matrix &expected, const S21Matrix &bound) {
+  if (value.GetRows() != expected.GetRows() ||
+      value.GetCols() != expected.GetCols()) {
+    std::ostringstream out;
+    out << path << ": shape " << value.GetRows() << " x " << value.GetCols()
+        << ", reference " << expected.GetRows() << " x "
+        << expected.GetCols();
+    return out.str();
+  }
+  for (int i = 0; i < value.GetRows(); ++i) {
+    for (int j = 0; j < value.GetCols(); ++j) {
+      if (!(std::fabs(value(i, j) - expected(i, j)) <= bound(i, j))) {
+        return ValueMismatch(path, i, j, value(i, j), expected(i, j),
+                             bound(i, j));
+      }
+    }
+  }
+  return "";
+}
+
+std::string Mismatch(const char *path, const S21Result<S21Matrix> &value,
+                     const S21Matrix &expected, const S21Matrix &bound) {
+  if (!value) return StatusMismatch(path, value.GetStatus(), S21Status::kOk);
+  return Mismatch(path, *value, expected, bound);
+}
+
+S21Matrix Filled(int rows, int cols, double value) {
+  S21Matrix result(rows, cols);
+  result.NumberFillMatrix(value);
+  return result;
+}
+
+}  // namespace
+
+S21Matrix S21Reference::Multiply(const S21Matrix &a, const S21Matrix &b) {
+  if (a.GetCols() != b.GetRows()) S21Throw(S21Status::kProductMismatch);
+  S21Matrix result(a.GetRows(), b.GetCols());
+  for (int i = 0; i < a.GetRows(); i++) {
+    for (int j = 0; j < b.GetCols(); j++) {
+      for (int k = 0; k < a.GetCols(); k++) {
+        result(i, j) += a(i, k) * b(k, j);
+      }
+    }
+  }
+  return result;
+}
+
+double S21Reference::Determinant(const S21Matrix &a) {
+  CheckExpandable(a);
+  return Expand(a.Data(), a.GetRows());
+}
+
+S21Matrix S21Reference::Inverse(const S21Matrix &a) {
+  double determinant = Determinant(a);
+  if (determinant == 0) S21Throw(S21Status::kSingular);
+  int n = a.GetRows();
+  S21Matrix result(n, n);
+  if (n == 1) {
+    result(0, 0) = 1 / determinant;
+    return result;
+  }
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      double minor_determinant = Expand(Minor(a, i, j).data(), n - 1);
+      result(j, i) = ((i + j) % 2 ? -1 : 1) * minor_determinant;
+    }
+  }
+  result *= 1 / determinant;
+  return result;
+}
+
+double S21Reference::ConditionNumber(const S21Matrix &a) {
+  if (Determinant(a) == 0) return std::numeric_limits<double>::infinity();
+  return a.Norm1() * Inverse(a).Norm1();
+}
+
+// Both sides are within k * kUnit * (|a| |b|)_ij of the exact product.
+std::string S21Reference::CheckProduct(const S21Matrix &a,
+                                       const S21Matrix &b) {
+  if (a.GetCols() != b.GetRows()) {
+    S21Matrix c(a);
+    return StatusMismatch("MulMatrix", c.TryMulMatrix(b),
+                          S21Status::kProductMismatch);
+  }
+  S21Matrix expected = Multiply(a, b);
+  S21Matrix bound = Multiply(Abs(a), Abs(b));
+  bound *= kSlack * a.GetCols() * kUnit;
+  for (S21Matrix::Accuracy accuracy :
+       {S21Matrix::Accuracy::kFast, S21Matrix::Accuracy::kCompensated}) {
+    const char *path = accuracy == S21Matrix::Accuracy::kFast
+                           ? "MulMatrix(kFast)"
+                           : "MulMatrix(kCompensated)";
+    S21Matrix c(a);
+    S21Status status = c.TryMulMatrix(b, accuracy);
+    std::string error = status == S21Status::kOk
+                            ? Mismatch(path, c, expected, bound)
+                            : StatusMismatch(path, status, S21Status::kOk);
+    if (!error.empty()) return error;
+  }
+  std::string error = Mismatch(
+      "MultiplyChain", S21Matrix::MultiplyChain({&a, &b}), expected, bound);
+  if (!error.empty()) return error;
+  // The transposed product lands on other kernels for skewed shapes.
+  return Mismatch("(b^T a^T)^T", (b.Transpose() * a.Transpose()).Transpose(),
+                  expected, bound);
+}
+
+// Elimination perturbs a by about n * kUnit * |a|. That moves the
+// determinant by at most n^2 * kUnit * cond * |det|, and by n^2 * kUnit
+// times the permanent of |a| when a is singular; the expansion itself errs
+// by at most n * kUnit * perm(|a|).
+std::string S21Reference::CheckDeterminant(const S21Matrix &a) {
+  if (a.GetRows() != a.GetCols()) {
+    return StatusMismatch("Determinant", a.TryDeterminant().GetStatus(),
+                          S21Status::kNotSquare);
+  }
+  int n = a.GetRows();
+  double expected = Determinant(a);
+  double scale = RowNormProduct(a);
+  if (expected != 0) scale += ConditionNumber(a) * std::fabs(expected);
+  double bound = kSlack * n * n * kUnit * scale;
+  const S21Matrix transposed = a.Transpose();
+  const struct {
+    const char *path;
+    const S21Matrix &matrix;
+  } paths[] = {{"Determinant", a}, {"Determinant of a^T", transposed}};
+  for (const auto &path : paths) {
+    S21Result<double> value = path.matrix.TryDeterminant();
+    if (!value) {
+      return StatusMismatch(path.path, value.GetStatus(), S21Status::kOk);
+    }
+    if (!std::isnan(bound) && !(std::fabs(*value - expected) <= bound)) {
+      return ValueMismatch(path.path, 0, 0, *value, expected, bound);
+    }
+  }
+  return "";
+}
+
+// Relative error of n * kUnit * cond for elimination; the adjugate adds
+// n * kUnit * perm(|a|) / |det| through the expansion.
+std::string S21Reference::CheckInverse(const S21Matrix &a) {
+  if (a.GetRows() != a.GetCols()) {
+    return StatusMismatch("InverseMatrix", a.TryInverseMatrix().GetStatus(),
+                          S21Status::kNotSquare);
+  }
+  int n = a.GetRows();
+  double condition = ConditionNumber(a);
+  const S21Matrix transposed = a.Transpose();
+  const struct {
+    const char *path;
+    S21Result<S21Matrix> value;
+    bool transposed;
+  } paths[] = {
+      {"InverseMatrix()", a.TryInverseMatrix(), false},
+      {"InverseMatrix(kMixed)",
+       a.TryInverseMatrix(S21Matrix::Precision::kMixed), false},
+      {"InverseMatrix() of a^T", transposed.TryInverseMatrix(), true},
+  };
+  if (!(condition <= kMaxCondition)) {
+    for (const auto &path : paths) {
+      if (!path.value && path.value.GetStatus() != S21Status::kSingular) {
+        return StatusMismatch(path.path, path.value.GetStatus(),
+                              S21Status::kSingular);
+      }
+    }
+    return "";
+  }
+  S21Matrix expected = Inverse(a);
+  double determinant = std::fabs(Determinant(a));
+  double relative =
+      kSlack * n * kUnit * (n * condition + RowNormProduct(a) / determinant);
+  S21Matrix bound = Filled(n, n, relative * expected.MaxAbs());
+  S21Matrix expected_transposed = expected.Transpose();
+  for (const auto &path : paths) {
+    std::string error =
+        Mismatch(path.path, path.value,
+                 path.transposed ? expected_transposed : expected, bound);
+    if (!error.empty()) return error;
+  }
+  return "";
+}
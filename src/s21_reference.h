@@ -0,0 +1,38 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_REFERENCE_H
+#define CPP1_S21_MATRIXPLUS_S21_REFERENCE_H
+
+#include <string>
+
+#include "s21_matrix_oop.h"
+
+// The straightforward algorithms the library started with, kept as the
+// reference its optimized paths are checked against: the i-j-k triple loop
+// product, Laplace expansion along the rows and the adjugate inverse. The
+// expansion reuses minors over the same columns, which brings it from
+// O(n!) down to O(2^n n) without changing what is summed, and is limited
+// to kMaxCofactorSize rows.
+class S21Reference {
+ public:
+  static const int kMaxCofactorSize = 10;
+
+  static S21Matrix Multiply(const S21Matrix &a, const S21Matrix &b);
+  static double Determinant(const S21Matrix &a);
+  static S21Matrix Inverse(const S21Matrix &a);
+  // ||a||_1 * ||a^-1||_1, infinite for a singular matrix.
+  static double ConditionNumber(const S21Matrix &a);
+
+  // Differential checks. Each runs every optimized path of the operation
+  // with the current S21Parallel::GetNumThreads() and returns an empty
+  // string when all of them agree with the reference within a forward
+  // error bound, else a description of the first disagreement. The bounds
+  // grow with the dimensions and, for the determinant and the inverse,
+  // with the condition number. Past kMaxCondition an inverse is only
+  // checked to be computed or reported singular, as any answer is then as
+  // good as another.
+  static constexpr double kMaxCondition = 1e12;
+  static std::string CheckProduct(const S21Matrix &a, const S21Matrix &b);
+  static std::string CheckDeterminant(const S21Matrix &a);
+  static std::string CheckInverse(const S21Matrix &a);
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_REFERENCE_H
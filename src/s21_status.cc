@@ -0,0 +1,65 @@
+#include "s21_status.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+const char *S21StatusMessage(S21Status status) {
+  switch (status) {
+    case S21Status::kOk:
+      return "Success.";
+    case S21Status::kInvalidSize:
+      return "Error: rows and columns must be more than 0.";
+    case S21Status::kDimensionMismatch:
+      return "Different matrix dimensions.";
+    case S21Status::kProductMismatch:
+      return "The number of columns of the first matrix does not equal the "
+             "number of rows of the second matrix.";
+    case S21Status::kNotSquare:
+      return "The matrix is not square.";
+    case S21Status::kInvalidMatrix:
+      return "The matrix does not have the required structure.";
+    case S21Status::kSingular:
+      return "Matrix determinant is 0.";
+    case S21Status::kIndexOutOfRange:
+      return "Index is outside the matrix.";
+    case S21Status::kInvalidArgument:
+      return "Invalid argument.";
+    case S21Status::kNotConverged:
+      return "Iteration did not converge.";
+    case S21Status::kOverflow:
+      return "Integer overflow.";
+    case S21Status::kOutOfMemory:
+      return "Out of memory.";
+    case S21Status::kMemoryLimit:
+      return "The operation would exceed the memory limit.";
+    case S21Status::kTransportFailed:
+      return "Distributed computation failed.";
+  }
+  return "Unknown error.";
+}
+
+void S21Throw(S21Status status, const char *message) {
+  if (message == nullptr) message = S21StatusMessage(status);
+#if defined(__cpp_exceptions)
+  switch (status) {
+    case S21Status::kInvalidArgument:
+      throw std::invalid_argument(message);
+    case S21Status::kNotConverged:
+    case S21Status::kTransportFailed:
+      throw std::runtime_error(message);
+    case S21Status::kOverflow:
+      throw std::overflow_error(message);
+    case S21Status::kOutOfMemory:
+      throw std::bad_alloc();
+    case S21Status::kMemoryLimit:
+      throw std::length_error(message);
+    default:
+      throw std::out_of_range(message);
+  }
+#else
+  std::fprintf(stderr, "%s\n", message);
+  std::abort();
+#endif
+}
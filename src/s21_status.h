@@ -0,0 +1,94 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_STATUS_H
+#define CPP1_S21_MATRIXPLUS_S21_STATUS_H
+
+#include <cassert>
+#include <optional>
+#include <utility>
+
+// Error codes of the non-throwing API. Each maps to the exception the
+// throwing API raises for the same failure.
+enum class S21Status {
+  kOk,
+  kInvalidSize,        // Non-positive dimensions (std::out_of_range)
+  kDimensionMismatch,  // Operands of different shapes (std::out_of_range)
+  kProductMismatch,    // Left columns != right rows (std::out_of_range)
+  kNotSquare,          // std::out_of_range
+  kInvalidMatrix,      // Not symmetric, not positive definite, ...
+  kSingular,           // Zero determinant or pivot (std::out_of_range)
+  kIndexOutOfRange,    // std::out_of_range
+  kInvalidArgument,    // std::invalid_argument
+  kNotConverged,       // Iterative method gave up (std::runtime_error)
+  kOverflow,           // Exact arithmetic overflowed (std::overflow_error)
+  kOutOfMemory,        // std::bad_alloc
+  kMemoryLimit,        // Over S21Memory::GetLimit() (std::length_error)
+  kTransportFailed,    // Worker process or channel (std::runtime_error)
+};
+
+// Default message of each status, as used by the exceptions.
+const char *S21StatusMessage(S21Status status);
+
+// Raises the exception of 'status' with 'message', or the default message
+// when it is null. Built with -fno-exceptions it prints the message and
+// aborts instead, so library code raises all errors through here.
+[[noreturn]] void S21Throw(S21Status status, const char *message = nullptr);
+
+// try/catch (...) that compile away with -fno-exceptions, where there is
+// nothing to catch; the handler becomes dead code.
+#if defined(__cpp_exceptions)
+#define S21_TRY try
+#define S21_CATCH_ALL catch (...)
+#else
+#define S21_TRY if (true)
+#define S21_CATCH_ALL if (false)
+#endif
+
+inline void S21ThrowIfError(S21Status status) {
+  if (status != S21Status::kOk) S21Throw(status);
+}
+
+// Value or error code, in the style of std::expected. Value() is unchecked
+// (asserts in debug builds); ValueOrThrow() converts the error back into
+// the exception of the throwing API.
+template <typename T>
+class S21Result {
+ public:
+  S21Result(T value) : value_(std::move(value)) {}
+  S21Result(S21Status status) : status_(status) {
+    assert(status != S21Status::kOk);
+  }
+
+  bool Ok() const { return status_ == S21Status::kOk; }
+  explicit operator bool() const { return Ok(); }
+  S21Status GetStatus() const { return status_; }
+
+  T &Value() & {
+    assert(Ok());
+    return *value_;
+  }
+  const T &Value() const & {
+    assert(Ok());
+    return *value_;
+  }
+  T &&Value() && {
+    assert(Ok());
+    return std::move(*value_);
+  }
+  T &operator*() & { return Value(); }
+  const T &operator*() const & { return Value(); }
+  T *operator->() { return &Value(); }
+  const T *operator->() const { return &Value(); }
+
+  T ValueOr(T fallback) && {
+    return Ok() ? std::move(*value_) : std::move(fallback);
+  }
+  T ValueOrThrow() && {
+    S21ThrowIfError(status_);
+    return std::move(*value_);
+  }
+
+ private:
+  S21Status status_ = S21Status::kOk;
+  std::optional<T> value_;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_STATUS_H
@@ -0,0 +1,446 @@
+#include "s21_structured.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "s21_parallel.h"
+#include "s21_status.h"
+
+namespace {
+
+// Rows handled per chunk by the row-parallel kernels below.
+const std::size_t kGrainRows = 32;
+
+void CheckSize(int size) {
+  if (size < 1) {
+    S21Throw(S21Status::kInvalidSize, "Error: size must be more than 0.");
+  }
+}
+
+void CheckSquare(const S21Matrix &matrix) {
+  if (matrix.GetRows() != matrix.GetCols()) {
+    S21Throw(S21Status::kNotSquare);
+  }
+}
+
+void CheckProduct(int cols, const S21Matrix &other) {
+  if (cols != other.GetRows()) {
+    S21Throw(S21Status::kProductMismatch);
+  }
+}
+
+}  // namespace
+
+// S21SymmetricMatrix
+
+S21SymmetricMatrix::S21SymmetricMatrix(int size) : size_(size) {
+  CheckSize(size);
+  packed_.assign(static_cast<std::size_t>(size) * (size + 1) / 2, 0.0);
+}
+
+S21SymmetricMatrix S21SymmetricMatrix::FromMatrix(const S21Matrix &matrix) {
+  CheckSquare(matrix);
+  S21SymmetricMatrix result(matrix.GetRows());
+  for (int i = 0; i < result.size_; ++i) {
+    const double *row = matrix[i];
+    std::copy(row, row + i + 1, result.packed_.begin() + result.Index(i, 0));
+  }
+  return result;
+}
+
+S21SymmetricMatrix S21SymmetricMatrix::Syrk(const S21Matrix &a) {
+  int n = a.GetRows();
+  int k = a.GetCols();
+  S21SymmetricMatrix result(n);
+  S21Parallel::For(0, n, kGrainRows, [&](std::size_t first, std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+      const double *ai = a[i];
+      double *out = result.packed_.data() + result.Index(i, 0);
+      for (std::size_t j = 0; j <= i; ++j) {
+        const double *aj = a[j];
+        double sum = 0;
+        for (int p = 0; p < k; ++p) sum += ai[p] * aj[p];
+        out[j] = sum;
+      }
+    }
+  });
+  return result;
+}
+
+int S21SymmetricMatrix::GetSize() const { return size_; }
+
+double &S21SymmetricMatrix::operator()(int row, int col) {
+  if (row >= size_ || col >= size_ || row < 0 || col < 0) {
+    S21Throw(S21Status::kIndexOutOfRange);
+  }
+  return packed_[Index(row, col)];
+}
+
+double S21SymmetricMatrix::operator()(int row, int col) const {
+  if (row >= size_ || col >= size_ || row < 0 || col < 0) {
+    S21Throw(S21Status::kIndexOutOfRange);
+  }
+  return packed_[Index(row, col)];
+}
+
+S21Matrix S21SymmetricMatrix::ToMatrix() const {
+  S21Matrix result(size_, size_);
+  for (int i = 0; i < size_; ++i) {
+    for (int j = 0; j <= i; ++j) {
+      result[i][j] = result[j][i] = packed_[Index(i, j)];
+    }
+  }
+  return result;
+}
+
+S21Matrix S21SymmetricMatrix::MulMatrix(const S21Matrix &other) const {
+  CheckProduct(size_, other);
+  int m = other.GetCols();
+  S21Matrix result(size_, m);
+  S21Parallel::For(0, size_, kGrainRows, [&](std::size_t first,
+                                             std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+      double *ci = result[i];
+      for (int p = 0; p < size_; ++p) {
+        double value = packed_[Index(i, p)];
+        const double *bp = other[p];
+        for (int j = 0; j < m; ++j) ci[j] += value * bp[j];
+      }
+    }
+  });
+  return result;
+}
+
+std::size_t S21SymmetricMatrix::Index(int row, int col) const {
+  if (row < col) std::swap(row, col);
+  return static_cast<std::size_t>(row) * (row + 1) / 2 + col;
+}
+
+// S21TriangularMatrix
+
+S21TriangularMatrix::S21TriangularMatrix(int size, Triangle triangle)
+    : size_(size), triangle_(triangle) {
+  CheckSize(size);
+  packed_.assign(static_cast<std::size_t>(size) * (size + 1) / 2, 0.0);
+}
+
+S21TriangularMatrix S21TriangularMatrix::FromMatrix(const S21Matrix &matrix,
+                                                    Triangle triangle) {
+  CheckSquare(matrix);
+  S21TriangularMatrix result(matrix.GetRows(), triangle);
+  for (int i = 0; i < result.size_; ++i) {
+    int first = triangle == Triangle::kLower ? 0 : i;
+    int last = triangle == Triangle::kLower ? i + 1 : result.size_;
+    std::copy(matrix[i] + first, matrix[i] + last,
+              result.packed_.begin() + result.Index(i, first));
+  }
+  return result;
+}
+
+int S21TriangularMatrix::GetSize() const { return size_; }
+
+S21TriangularMatrix::Triangle S21TriangularMatrix::GetTriangle() const {
+  return triangle_;
+}
+
+double &S21TriangularMatrix::operator()(int row, int col) {
+  if (row >= size_ || col >= size_ || row < 0 || col < 0) {
+    S21Throw(S21Status::kIndexOutOfRange);
+  }
+  if (!InTriangle(row, col)) {
+    S21Throw(S21Status::kIndexOutOfRange,
+             "Index is outside the stored triangle.");
+  }
+  return packed_[Index(row, col)];
+}
+
+double S21TriangularMatrix::operator()(int row, int col) const {
+  if (row >= size_ || col >= size_ || row < 0 || col < 0) {
+    S21Throw(S21Status::kIndexOutOfRange);
+  }
+  return InTriangle(row, col) ? packed_[Index(row, col)] : 0.0;
+}
+
+S21Matrix S21TriangularMatrix::ToMatrix() const {
+  S21Matrix result(size_, size_);
+  for (int i = 0; i < size_; ++i) {
+    for (int j = 0; j < size_; ++j) {
+      if (InTriangle(i, j)) result[i][j] = packed_[Index(i, j)];
+    }
+  }
+  return result;
+}
+
+S21Matrix S21TriangularMatrix::MulMatrix(const S21Matrix &other) const {
+  CheckProduct(size_, other);
+  int m = other.GetCols();
+  S21Matrix result(size_, m);
+  S21Parallel::For(0, size_, kGrainRows, [&](std::size_t first,
+                                             std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+      int row = static_cast<int>(i);
+      int begin = triangle_ == Triangle::kLower ? 0 : row;
+      int end = triangle_ == Triangle::kLower ? row + 1 : size_;
+      double *ci = result[row];
+      const double *ai = packed_.data() + Index(row, begin);
+      for (int p = begin; p < end; ++p) {
+        double value = ai[p - begin];
+        const double *bp = other[p];
+        for (int j = 0; j < m; ++j) ci[j] += value * bp[j];
+      }
+    }
+  });
+  return result;
+}
+
+double S21TriangularMatrix::Determinant() const {
+  double determinant = 1;
+  for (int i = 0; i < size_; ++i) determinant *= packed_[Index(i, i)];
+  return determinant;
+}
+
+S21Matrix S21TriangularMatrix::Solve(const S21Matrix &b) const {
+  if (b.GetRows() != size_) {
+    S21Throw(S21Status::kDimensionMismatch,
+             "The number of rows of the right-hand side does not equal "
+             "the size of the matrix.");
+  }
+  CheckNonSingular();
+  int m = b.GetCols();
+  S21Matrix x(b);
+  bool lower = triangle_ == Triangle::kLower;
+  for (int step = 0; step < size_; ++step) {
+    int i = lower ? step : size_ - 1 - step;
+    int begin = lower ? 0 : i + 1;
+    int end = lower ? i : size_;
+    double *xi = x[i];
+    for (int p = begin; p < end; ++p) {
+      double value = packed_[Index(i, p)];
+      const double *xp = x[p];
+      for (int j = 0; j < m; ++j) xi[j] -= value * xp[j];
+    }
+    double inverse_diagonal = 1.0 / packed_[Index(i, i)];
+    for (int j = 0; j < m; ++j) xi[j] *= inverse_diagonal;
+  }
+  return x;
+}
+
+// Column j of the inverse only touches rows inside the triangle, so each
+// column is an independent substitution over n - j (or j + 1) rows.
+S21TriangularMatrix S21TriangularMatrix::InverseMatrix() const {
+  CheckNonSingular();
+  S21TriangularMatrix result(size_, triangle_);
+  bool lower = triangle_ == Triangle::kLower;
+  S21Parallel::For(0, size_, kGrainRows, [&](std::size_t first,
+                                             std::size_t last) {
+    for (std::size_t column = first; column < last; ++column) {
+      int j = static_cast<int>(column);
+      result.packed_[Index(j, j)] = 1.0 / packed_[Index(j, j)];
+      for (int step = 1; step < size_; ++step) {
+        int i = lower ? j + step : j - step;
+        if (i < 0 || i >= size_) break;
+        int begin = lower ? j : i + 1;
+        int end = lower ? i : j + 1;
+        double sum = 0;
+        for (int p = begin; p < end; ++p) {
+          sum += packed_[Index(i, p)] * result.packed_[Index(p, j)];
+        }
+        result.packed_[Index(i, j)] = -sum / packed_[Index(i, i)];
+      }
+    }
+  });
+  return result;
+}
+
+bool S21TriangularMatrix::InTriangle(int row, int col) const {
+  return triangle_ == Triangle::kLower ? col <= row : col >= row;
+}
+
+std::size_t S21TriangularMatrix::Index(int row, int col) const {
+  std::size_t i = row;
+  if (triangle_ == Triangle::kLower) return i * (i + 1) / 2 + col;
+  return i * size_ - i * (i - 1) / 2 + (col - row);
+}
+
+void S21TriangularMatrix::CheckNonSingular() const {
+  for (int i = 0; i < size_; ++i) {
+    if (packed_[Index(i, i)] == 0) {
+      S21Throw(S21Status::kSingular);
+    }
+  }
+}
+
+// S21Cholesky
+
+// Row i of L is packed contiguously, so each entry is a dot product of two
+// row prefixes.
+S21Cholesky::S21Cholesky(const S21SymmetricMatrix &matrix)
+    : factor_(matrix.GetSize(), S21TriangularMatrix::Triangle::kLower) {
+  const int n = matrix.GetSize();
+  std::vector<double> &l = factor_.packed_;
+  for (int i = 0; i < n; ++i) {
+    double *li = l.data() + factor_.Index(i, 0);
+    for (int j = 0; j <= i; ++j) {
+      const double *lj = l.data() + factor_.Index(j, 0);
+      double sum = matrix.packed_[matrix.Index(i, j)];
+      for (int p = 0; p < j; ++p) sum -= li[p] * lj[p];
+      if (j < i) {
+        li[j] = sum / lj[j];
+      } else if (sum > 0) {
+        li[i] = std::sqrt(sum);
+      } else {
+        S21Throw(S21Status::kInvalidMatrix, "Matrix is not positive definite.");
+      }
+    }
+  }
+}
+
+int S21Cholesky::GetSize() const { return factor_.GetSize(); }
+
+const S21TriangularMatrix &S21Cholesky::GetFactor() const { return factor_; }
+
+double S21Cholesky::Determinant() const {
+  double determinant = factor_.Determinant();
+  return determinant * determinant;
+}
+
+// L^T x = y runs backwards through the rows of L: once x_i is known, row i
+// of L holds its contribution to every earlier unknown.
+S21Matrix S21Cholesky::Solve(const S21Matrix &b) const {
+  S21Matrix x = factor_.Solve(b);
+  const int m = b.GetCols();
+  const std::vector<double> &l = factor_.packed_;
+  for (int i = GetSize() - 1; i >= 0; --i) {
+    const double *li = l.data() + factor_.Index(i, 0);
+    double *xi = x[i];
+    double inverse_diagonal = 1.0 / li[i];
+    for (int j = 0; j < m; ++j) xi[j] *= inverse_diagonal;
+    for (int p = 0; p < i; ++p) {
+      double *xp = x[p];
+      for (int j = 0; j < m; ++j) xp[j] -= li[p] * xi[j];
+    }
+  }
+  return x;
+}
+
+void S21Cholesky::Update(const S21Matrix &x) { Rotate(x, 1); }
+
+void S21Cholesky::Downdate(const S21Matrix &x) { Rotate(x, -1); }
+
+// Works on a copy of the factor, so a failed downdate changes nothing.
+void S21Cholesky::Rotate(const S21Matrix &x, double sign) {
+  const int n = GetSize();
+  if (x.GetRows() != n || x.GetCols() != 1) {
+    S21Throw(S21Status::kDimensionMismatch);
+  }
+  std::vector<double> l = factor_.packed_;
+  std::vector<double> w(x.begin(), x.end());
+  for (int k = 0; k < n; ++k) {
+    double &diagonal = l[factor_.Index(k, k)];
+    double squared = diagonal * diagonal + sign * w[k] * w[k];
+    if (!(squared > 0)) {
+      S21Throw(S21Status::kInvalidMatrix, "Matrix is not positive definite.");
+    }
+    double r = std::sqrt(squared);
+    double c = r / diagonal;
+    double s = w[k] / diagonal;
+    diagonal = r;
+    for (int i = k + 1; i < n; ++i) {
+      double &lik = l[factor_.Index(i, k)];
+      lik = (lik + sign * s * w[i]) / c;
+      w[i] = c * w[i] - s * lik;
+    }
+  }
+  factor_.packed_ = std::move(l);
+}
+
+// S21BandMatrix
+
+S21BandMatrix::S21BandMatrix(int size, int lower, int upper)
+    : size_(size), lower_(lower), upper_(upper) {
+  CheckSize(size);
+  if (lower < 0 || upper < 0 || lower >= size || upper >= size) {
+    S21Throw(S21Status::kInvalidSize,
+             "Error: bandwidths must be in [0, size).");
+  }
+  band_.assign(static_cast<std::size_t>(size) * (lower + upper + 1), 0.0);
+}
+
+S21BandMatrix S21BandMatrix::FromMatrix(const S21Matrix &matrix, int lower,
+                                        int upper) {
+  CheckSquare(matrix);
+  S21BandMatrix result(matrix.GetRows(), lower, upper);
+  for (int i = 0; i < result.size_; ++i) {
+    int first = std::max(0, i - lower);
+    int last = std::min(result.size_ - 1, i + upper);
+    for (int j = first; j <= last; ++j) {
+      result.band_[result.Index(i, j)] = matrix[i][j];
+    }
+  }
+  return result;
+}
+
+int S21BandMatrix::GetSize() const { return size_; }
+
+int S21BandMatrix::GetLower() const { return lower_; }
+
+int S21BandMatrix::GetUpper() const { return upper_; }
+
+double &S21BandMatrix::operator()(int row, int col) {
+  if (row >= size_ || col >= size_ || row < 0 || col < 0) {
+    S21Throw(S21Status::kIndexOutOfRange);
+  }
+  if (!InBand(row, col)) {
+    S21Throw(S21Status::kIndexOutOfRange, "Index is outside the band.");
+  }
+  return band_[Index(row, col)];
+}
+
+double S21BandMatrix::operator()(int row, int col) const {
+  if (row >= size_ || col >= size_ || row < 0 || col < 0) {
+    S21Throw(S21Status::kIndexOutOfRange);
+  }
+  return InBand(row, col) ? band_[Index(row, col)] : 0.0;
+}
+
+S21Matrix S21BandMatrix::ToMatrix() const {
+  S21Matrix result(size_, size_);
+  for (int i = 0; i < size_; ++i) {
+    for (int j = std::max(0, i - lower_); j <= std::min(size_ - 1, i + upper_);
+         ++j) {
+      result[i][j] = band_[Index(i, j)];
+    }
+  }
+  return result;
+}
+
+S21Matrix S21BandMatrix::MulMatrix(const S21Matrix &other) const {
+  CheckProduct(size_, other);
+  int m = other.GetCols();
+  S21Matrix result(size_, m);
+  S21Parallel::For(0, size_, kGrainRows, [&](std::size_t first,
+                                             std::size_t last) {
+    for (std::size_t i = first; i < last; ++i) {
+      int row = static_cast<int>(i);
+      double *ci = result[row];
+      int begin = std::max(0, row - lower_);
+      int end = std::min(size_ - 1, row + upper_);
+      for (int p = begin; p <= end; ++p) {
+        double value = band_[Index(row, p)];
+        const double *bp = other[p];
+        for (int j = 0; j < m; ++j) ci[j] += value * bp[j];
+      }
+    }
+  });
+  return result;
+}
+
+bool S21BandMatrix::InBand(int row, int col) const {
+  return col >= row - lower_ && col <= row + upper_;
+}
+
+std::size_t S21BandMatrix::Index(int row, int col) const {
+  return static_cast<std::size_t>(row) * (lower_ + upper_ + 1) +
+         (col - row + lower_);
+}
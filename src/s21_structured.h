@@ -0,0 +1,124 @@
+#ifndef CPP1_S21_MATRIXPLUS_S21_STRUCTURED_H
+#define CPP1_S21_MATRIXPLUS_S21_STRUCTURED_H
+
+#include <cstddef>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+struct S21EigenResult;
+
+// Symmetric n x n matrix storing only the lower triangle, packed row by row
+// (n * (n + 1) / 2 elements).
+class S21SymmetricMatrix {
+ public:
+  explicit S21SymmetricMatrix(int size);
+  // Takes the lower triangle of a square matrix.
+  static S21SymmetricMatrix FromMatrix(const S21Matrix &matrix);
+  // a * a^T, computing only the lower triangle (SYRK).
+  static S21SymmetricMatrix Syrk(const S21Matrix &a);
+
+  int GetSize() const;
+  double &operator()(int row, int col);  // (row, col) and (col, row) alias
+  double operator()(int row, int col) const;
+
+  S21Matrix ToMatrix() const;
+  S21Matrix MulMatrix(const S21Matrix &other) const;  // this * other
+  S21EigenResult Eigen() const;  // See S21Matrix::SymmetricEigen
+
+ private:
+  friend class S21Cholesky;
+  std::size_t Index(int row, int col) const;
+
+  int size_;
+  std::vector<double> packed_;
+};
+
+// Square triangular matrix storing only its triangle, packed row by row.
+class S21TriangularMatrix {
+ public:
+  enum class Triangle { kLower, kUpper };
+
+  S21TriangularMatrix(int size, Triangle triangle);
+  // Takes the given triangle of a square matrix, ignoring the rest.
+  static S21TriangularMatrix FromMatrix(const S21Matrix &matrix,
+                                        Triangle triangle);
+
+  int GetSize() const;
+  Triangle GetTriangle() const;
+  // Checked access to the stored triangle.
+  double &operator()(int row, int col);
+  // Any position; zero outside the stored triangle.
+  double operator()(int row, int col) const;
+
+  S21Matrix ToMatrix() const;
+  S21Matrix MulMatrix(const S21Matrix &other) const;  // this * other
+  double Determinant() const;                         // Diagonal product
+  S21Matrix Solve(const S21Matrix &b) const;          // Substitution, O(n^2)
+  S21TriangularMatrix InverseMatrix() const;          // O(n^3 / 3)
+
+ private:
+  friend class S21Cholesky;
+  bool InTriangle(int row, int col) const;
+  std::size_t Index(int row, int col) const;
+  void CheckNonSingular() const;
+
+  int size_;
+  Triangle triangle_;
+  std::vector<double> packed_;
+};
+
+// Cholesky factorization A = L * L^T of a symmetric positive definite
+// matrix, with O(n^2) rank-1 updates in place of refactoring.
+class S21Cholesky {
+ public:
+  // Throws std::out_of_range when the matrix is not positive definite.
+  explicit S21Cholesky(const S21SymmetricMatrix &matrix);
+
+  int GetSize() const;
+  const S21TriangularMatrix &GetFactor() const;  // L, lower triangular
+  double Determinant() const;
+  S21Matrix Solve(const S21Matrix &b) const;  // Two substitutions, O(n^2)
+
+  // Refactor A + x * x^T and A - x * x^T for a GetSize() x 1 column x by
+  // Givens (hyperbolic) rotations. Downdate throws std::out_of_range and
+  // leaves the factor unchanged when the result is not positive definite.
+  void Update(const S21Matrix &x);
+  void Downdate(const S21Matrix &x);
+
+ private:
+  void Rotate(const S21Matrix &x, double sign);
+
+  S21TriangularMatrix factor_;
+};
+
+// Square band matrix with 'lower' sub- and 'upper' superdiagonals. Row i
+// stores columns i - lower .. i + upper, so storage is n * (lower + upper + 1).
+class S21BandMatrix {
+ public:
+  S21BandMatrix(int size, int lower, int upper);
+  // Takes the band of a square matrix, ignoring the rest.
+  static S21BandMatrix FromMatrix(const S21Matrix &matrix, int lower,
+                                  int upper);
+
+  int GetSize() const;
+  int GetLower() const;
+  int GetUpper() const;
+  // Checked access to positions inside the band.
+  double &operator()(int row, int col);
+  // Any position; zero outside the band.
+  double operator()(int row, int col) const;
+
+  S21Matrix ToMatrix() const;
+  // this * other in O(n * bandwidth * other.GetCols()).
+  S21Matrix MulMatrix(const S21Matrix &other) const;
+
+ private:
+  bool InBand(int row, int col) const;
+  std::size_t Index(int row, int col) const;
+
+  int size_, lower_, upper_;
+  std::vector<double> band_;
+};
+
+#endif  // CPP1_S21_MATRIXPLUS_S21_STRUCTURED_H
@@ -1,6 +1,29 @@
 #include <gtest/gtest.h>
-
+#include <sched.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "s21_async.h"
+#include "s21_decomposition.h"
+#include "s21_distributed.h"
+#include "s21_integer.h"
+#include "s21_kernels.h"
 #include "s21_matrix_oop.h"
+#include "s21_memory.h"
+#include "s21_parallel.h"
+#include "s21_random.h"
+#include "s21_reference.h"
+#include "s21_status.h"
+#include "s21_structured.h"
 
 // Constructors and destructor
 
@@ -401,6 +424,304 @@ TEST(Operators, mul_assign_num_2) {
   EXPECT_TRUE(A == B);
 }
 
+// Element access
+
+TEST(Access, at_and_brackets) {
+  S21Matrix A(2, 3);
+  A.At(1, 2) = 5;
+  A[0][1] = 7;
+  EXPECT_EQ(A(1, 2), 5);
+  EXPECT_EQ(A.At(0, 1), 7);
+  EXPECT_EQ(A[1][2], 5);
+  EXPECT_EQ(A.Data()[5], 5);
+  EXPECT_ANY_THROW({ A.At(2, 0); });
+  EXPECT_ANY_THROW({ A.At(0, -1); });
+  const S21Matrix &B = A;
+  EXPECT_EQ(B.At(0, 1), 7);
+  EXPECT_EQ(B[0][1], 7);
+  EXPECT_ANY_THROW({ B.At(0, 3); });
+}
+
+TEST(Access, iterators) {
+  S21Matrix A(3, 4);
+  std::iota(A.begin(), A.end(), 0.0);
+  EXPECT_EQ(A.end() - A.begin(), 12);
+  EXPECT_EQ(A(1, 0), 4);
+  EXPECT_EQ(A(2, 3), 11);
+  EXPECT_EQ(std::accumulate(A.cbegin(), A.cend(), 0.0), 66);
+  EXPECT_EQ(*std::max_element(A.begin(), A.end()), 11);
+}
+
+TEST(Access, row_span) {
+  S21Matrix A(3, 4);
+  for (double &value : A.Row(1)) value = 2;
+  EXPECT_EQ(A.Row(1).size(), 4);
+  EXPECT_EQ(A(1, 3), 2);
+  EXPECT_EQ(A(0, 3), 0);
+  EXPECT_EQ(A(2, 0), 0);
+  const S21Matrix &B = A;
+  EXPECT_EQ(std::accumulate(B.Row(1).begin(), B.Row(1).end(), 0.0), 8);
+  EXPECT_EQ(B.Row(1)[2], 2);
+}
+
+TEST(Access, moved_from_is_empty) {
+  S21Matrix A(2, 2);
+  S21Matrix B(std::move(A));
+  EXPECT_EQ(A.begin(), A.end());
+  S21Matrix C(A);
+  EXPECT_EQ(C.GetRows(), 0);
+  EXPECT_EQ(C.Data(), nullptr);
+}
+
+// Random fill
+
+TEST(RandomFill, random_fill_digits) {
+  S21Matrix A(20, 20);
+  A.RandomFillMatrix();
+  for (double value : A) {
+    EXPECT_GE(value, 0);
+    EXPECT_LE(value, 9);
+    EXPECT_EQ(value, std::floor(value));
+  }
+}
+
+TEST(RandomFill, uniform) {
+  S21Matrix A(100, 101);
+  A.UniformFillMatrix(-2, 3, 42);
+  double sum = 0;
+  for (double value : A) {
+    EXPECT_GE(value, -2);
+    EXPECT_LT(value, 3);
+    sum += value;
+  }
+  EXPECT_NEAR(sum / (100 * 101), 0.5, 0.05);
+  EXPECT_ANY_THROW({ A.UniformFillMatrix(1, 1, 42); });
+}
+
+TEST(RandomFill, normal) {
+  S21Matrix A(200, 201);
+  A.NormalFillMatrix(1, 2, 7);
+  double sum = 0, sum_sq = 0;
+  for (double value : A) {
+    sum += value;
+    sum_sq += value * value;
+  }
+  double n = 200 * 201;
+  double mean = sum / n;
+  EXPECT_NEAR(mean, 1, 0.05);
+  EXPECT_NEAR(std::sqrt(sum_sq / n - mean * mean), 2, 0.05);
+}
+
+TEST(RandomFill, integer) {
+  S21Matrix A(50, 50);
+  A.IntegerFillMatrix(-3, 3, 1);
+  bool seen_low = false, seen_high = false;
+  for (double value : A) {
+    EXPECT_GE(value, -3);
+    EXPECT_LE(value, 3);
+    EXPECT_EQ(value, std::floor(value));
+    seen_low = seen_low || value == -3;
+    seen_high = seen_high || value == 3;
+  }
+  EXPECT_TRUE(seen_low && seen_high);
+  EXPECT_ANY_THROW({ A.IntegerFillMatrix(2, 1, 1); });
+}
+
+TEST(RandomFill, deterministic_across_threads) {
+  S21Matrix A(301, 299);
+  S21Matrix B(301, 299);
+  S21Parallel::SetNumThreads(1);
+  A.NormalFillMatrix(0, 1, 123);
+  S21Parallel::SetNumThreads(4);
+  B.NormalFillMatrix(0, 1, 123);
+  S21Parallel::SetNumThreads(0);
+  EXPECT_TRUE(std::equal(A.begin(), A.end(), B.begin()));
+  B.NormalFillMatrix(0, 1, 124);
+  EXPECT_FALSE(std::equal(A.begin(), A.end(), B.begin()));
+}
+
+TEST(RandomFill, philox_batch_matches_single) {
+  S21Philox philox(99);
+  std::uint32_t batch[40 * S21Philox::kWordsPerBlock];
+  philox.Blocks(1000, 40, batch);
+  for (int b = 0; b < 40; ++b) {
+    std::uint32_t single[S21Philox::kWordsPerBlock];
+    philox.Block(1000 + b, single);
+    for (int w = 0; w < S21Philox::kWordsPerBlock; ++w) {
+      EXPECT_EQ(single[w], batch[b * S21Philox::kWordsPerBlock + w]);
+    }
+  }
+}
+
+// Memory placement
+
+TEST(Memory, large_blocks) {
+  std::size_t threshold = S21Memory::GetLargeThreshold();
+  S21Memory::SetLargeThreshold(1024);
+  for (S21Memory::Placement placement :
+       {S21Memory::Placement::kFirstTouch, S21Memory::Placement::kInterleave}) {
+    S21Memory::SetPlacement(placement);
+    S21Matrix A(100, 70);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(A.Data()) %
+                  S21Memory::kAlignment,
+              0u);
+    EXPECT_EQ(std::count(A.begin(), A.end(), 0.0), 7000);
+    A.NumberFillMatrix(2);
+    S21Matrix B(A);
+    S21Matrix C(std::move(A));
+    EXPECT_TRUE(B == C);
+    S21Matrix small(2, 2);
+    EXPECT_EQ(std::count(small.begin(), small.end(), 0.0), 4);
+  }
+  S21Memory::SetPlacement(S21Memory::Placement::kFirstTouch);
+  S21Memory::SetLargeThreshold(threshold);
+}
+
+TEST(Memory, pinned_workers) {
+  EXPECT_GE(S21Parallel::GetNumaNodes(), 1);
+  S21Parallel::SetThreadPinning(true);
+  S21Parallel::SetNumThreads(3);
+  std::vector<int> hits(1000, 0);
+  std::atomic<int> unpinned{0};
+  S21Parallel::For(0, hits.size(), 10, [&](std::size_t first,
+                                           std::size_t last) {
+    // Bound before the first element is touched.
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    sched_getaffinity(0, sizeof(set), &set);
+    if (CPU_COUNT(&set) != 1) unpinned++;
+    for (std::size_t i = first; i < last; i++) hits[i]++;
+  });
+  S21Parallel::SetThreadPinning(false);
+  S21Parallel::SetNumThreads(0);
+  EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), 1000);
+  EXPECT_EQ(unpinned, 0);
+}
+
+// Memory accounting
+
+TEST(Memory, usage_accounting) {
+  std::size_t threshold = S21Memory::GetLargeThreshold();
+  S21Memory::SetLargeThreshold(1 << 16);
+  S21Memory::ResetPeak();
+  const S21Memory::Usage base = S21Memory::GetUsage();
+  const S21Memory::Usage thread_base = S21Memory::GetThreadUsage();
+  const std::size_t block = S21Memory::BlockBytes(100, 100);
+  {
+    S21Matrix A(100, 100);  // Mapped
+    S21Matrix B(10, 10);    // Heap
+    const std::size_t both = block + S21Memory::BlockBytes(10, 10);
+    EXPECT_EQ(S21Memory::GetUsage().current, base.current + both);
+    EXPECT_EQ(S21Memory::GetThreadUsage().current, thread_base.current + both);
+  }
+  EXPECT_EQ(S21Memory::GetUsage().current, base.current);
+  EXPECT_GE(S21Memory::GetUsage().peak, base.current + block);
+  S21Matrix moved;
+  std::thread worker([&] {
+    S21Matrix C(50, 50);
+    EXPECT_EQ(S21Memory::GetThreadUsage().current,
+              S21Memory::BlockBytes(50, 50));
+    moved = std::move(C);
+  });
+  worker.join();
+  EXPECT_EQ(S21Memory::GetThreadUsage().current, thread_base.current);
+  moved = S21Matrix(1, 1);  // Freed here, after its thread is gone
+  EXPECT_EQ(S21Memory::GetUsage().current,
+            base.current + S21Memory::BlockBytes(1, 1));
+  S21Memory::SetLargeThreshold(threshold);
+}
+
+TEST(Memory, limit_fails_early) {
+  S21Matrix A(60, 60);
+  A.UniformFillMatrix(-1, 1, 91);
+  for (int i = 0; i < 60; i++) A(i, i) += 60;
+  const std::size_t in_use = S21Memory::GetUsage().current;
+  S21Memory::SetLimit(in_use + S21Memory::BlockBytes(60, 60) / 2);
+  EXPECT_TRUE(S21Memory::IsLowMemory());
+  EXPECT_THROW(S21Matrix(60, 60), std::length_error);
+  EXPECT_EQ(S21Matrix::TryCreate(60, 60).GetStatus(),
+            S21Status::kMemoryLimit);
+  EXPECT_EQ(A.TryDeterminant().GetStatus(), S21Status::kMemoryLimit);
+  EXPECT_EQ(A.TryInverseMatrix().GetStatus(), S21Status::kMemoryLimit);
+  EXPECT_THROW(A.Solve(A), std::length_error);
+  EXPECT_EQ(S21Memory::GetUsage().current, in_use);
+  S21Memory::SetLimit(0);
+  EXPECT_FALSE(S21Memory::IsLowMemory());
+  EXPECT_NO_THROW(A.InverseMatrix());
+}
+
+TEST(Memory, low_memory_algorithms) {
+  S21Matrix A(300, 200);
+  S21Matrix B(200, 200);
+  A.UniformFillMatrix(-1, 1, 92);
+  B.UniformFillMatrix(-1, 1, 93);
+  for (int i = 0; i < 200; i++) B(i, i) += 20;
+  S21Matrix product = A * B;
+  S21Matrix inverse = B.InverseMatrix();
+  double determinant = B.Determinant();
+  S21Matrix C(A);
+  S21Matrix D(B);  // Nothing cached yet
+  const std::size_t in_use = S21Memory::GetUsage().current;
+  const std::size_t limit = in_use + S21Memory::BlockBytes(200, 200) + 4096;
+  S21Memory::SetLimit(limit);
+  S21Memory::ResetPeak();
+  C.MulMatrix(B);  // A full 300 x 200 result would not fit
+  EXPECT_TRUE(std::equal(C.begin(), C.end(), product.begin()));
+  EXPECT_TRUE(D.InverseMatrix().EqMatrix(inverse));
+  EXPECT_EQ(S21Memory::GetUsage().current, in_use);
+  EXPECT_NEAR(D.Determinant() / determinant, 1, 1e-9);
+  EXPECT_EQ(S21Memory::GetUsage().current, in_use);  // LU not kept
+  EXPECT_LE(S21Memory::GetUsage().peak, limit);
+  S21Memory::SetLimit(0);
+}
+
+TEST(Memory, try_api_out_of_memory) {
+  S21Matrix A(40, 40);
+  A.UniformFillMatrix(-1, 1, 94);
+  for (int i = 0; i < 40; i++) A(i, i) += 40;
+  S21Matrix b(40, 3);
+  b.UniformFillMatrix(-1, 1, 95);
+  S21Matrix small(3, 3);
+  small.UniformFillMatrix(1, 2, 96);
+  const S21Matrix product = A * A;
+  const S21Matrix solution = A.Solve(b);
+  const std::size_t in_use = S21Memory::GetUsage().current;
+  // Fails each allocation of a solve in turn; the first run that gets
+  // through all of them must give the answer.
+  for (S21Matrix::Precision precision :
+       {S21Matrix::Precision::kDouble, S21Matrix::Precision::kMixed}) {
+    bool solved = false;
+    for (int successes = 0; successes < 100 && !solved; ++successes) {
+      const S21Matrix C(A);
+      S21Memory::FailAfter(successes);
+      S21Result<S21Matrix> x = C.TrySolve(b, precision);
+      S21Memory::FailAfter(-1);
+      solved = x.Ok();
+      if (solved) {
+        EXPECT_TRUE(x->EqMatrix(solution));
+      } else {
+        EXPECT_EQ(x.GetStatus(), S21Status::kOutOfMemory);
+      }
+    }
+    EXPECT_TRUE(solved);
+  }
+  EXPECT_EQ(S21Memory::GetUsage().current, in_use);
+  S21Matrix C(A);
+  S21Memory::FailAfter(0);
+  EXPECT_EQ(S21Matrix::TryCreate(2, 2).GetStatus(), S21Status::kOutOfMemory);
+  EXPECT_EQ(C.TryMulMatrix(A), S21Status::kOutOfMemory);
+  EXPECT_EQ(C.TryDeterminant().GetStatus(), S21Status::kOutOfMemory);
+  EXPECT_EQ(C.TryInverseMatrix().GetStatus(), S21Status::kOutOfMemory);
+  EXPECT_EQ(small.TryInverseMatrix().GetStatus(), S21Status::kOutOfMemory);
+  EXPECT_THROW(C.Determinant(), std::bad_alloc);
+  S21Memory::FailAfter(-1);
+  EXPECT_TRUE(std::equal(C.begin(), C.end(), A.begin()));
+  EXPECT_EQ(S21Memory::GetUsage().current,
+            in_use + S21Memory::BlockBytes(40, 40));
+  EXPECT_EQ(C.TryMulMatrix(A), S21Status::kOk);
+  EXPECT_TRUE(std::equal(C.begin(), C.end(), product.begin()));
+}
+
 // Setters and Getters
 
 TEST(Setters, set_1) {
@@ -591,6 +912,92 @@ TEST(Matrix_operations, EqMatrix_3) {
   EXPECT_FALSE(A.EqMatrix(B));
 }
 
+TEST(Matrix_operations, Compare_modes) {
+  using Tolerance = S21Matrix::Tolerance;
+  S21Matrix A(20, 30);
+  A.UniformFillMatrix(-1e3, 1e3, 81);
+  S21Matrix B(A);
+  EXPECT_TRUE(A.Compare(B, Tolerance::Ulp(0)));
+  B(17, 29) = std::nextafter(B(17, 29), HUGE_VAL);
+  EXPECT_FALSE(A.Compare(B, Tolerance::Ulp(0)));
+  EXPECT_TRUE(A.Compare(B, Tolerance::Ulp(1)));
+  B(17, 29) = A(17, 29) * (1 + 1e-9);
+  EXPECT_TRUE(A.Compare(B, Tolerance::Relative(1e-8)));
+  EXPECT_FALSE(A.Compare(B, Tolerance::Relative(1e-10)));
+  B(17, 29) = A(17, 29) + 1e-8;
+  EXPECT_TRUE(A.EqMatrix(B));
+  B(0, 0) += 1e-3;
+  EXPECT_FALSE(A.EqMatrix(B));
+  EXPECT_TRUE(A.Compare(B, Tolerance::Absolute(1e-2)));
+  EXPECT_FALSE(A.Compare(S21Matrix(20, 31), Tolerance::Ulp(4)));
+  S21Matrix zero(1, 2), negative_zero(1, 2);
+  negative_zero(0, 0) = -0.0;
+  EXPECT_TRUE(zero.Compare(negative_zero, Tolerance::Ulp(0)));
+  EXPECT_TRUE(zero.Compare(negative_zero, Tolerance::Relative(0)));
+}
+
+TEST(Matrix_operations, Compare_non_finite) {
+  using Tolerance = S21Matrix::Tolerance;
+  const Tolerance modes[] = {Tolerance::Absolute(1e300),
+                             Tolerance::Relative(1), Tolerance::Ulp(1 << 30)};
+  S21Matrix A(2, 3);
+  A(0, 1) = HUGE_VAL;
+  A(1, 2) = -HUGE_VAL;
+  S21Matrix B(A);
+  for (const Tolerance &tolerance : modes) {
+    EXPECT_TRUE(A.Compare(B, tolerance));
+  }
+  A(1, 0) = std::numeric_limits<double>::quiet_NaN();
+  B(1, 0) = A(1, 0);
+  for (const Tolerance &tolerance : modes) {
+    EXPECT_FALSE(A.Compare(B, tolerance));
+    EXPECT_FALSE(B.Compare(A, tolerance));
+    EXPECT_FALSE(A.Compare(A, tolerance));
+  }
+  EXPECT_FALSE(A == B);
+  S21Matrix inf(1, 1), one(1, 1), negative_inf(1, 1);
+  inf(0, 0) = HUGE_VAL;
+  one(0, 0) = 1;
+  negative_inf(0, 0) = -HUGE_VAL;
+  const Tolerance loose[] = {Tolerance::Absolute(HUGE_VAL),
+                             Tolerance::Relative(2), Tolerance::Ulp(1 << 30)};
+  for (const Tolerance &tolerance : loose) {
+    EXPECT_FALSE(inf.Compare(one, tolerance));
+    EXPECT_FALSE(one.Compare(inf, tolerance));
+    EXPECT_FALSE(inf.Compare(negative_inf, tolerance));
+    EXPECT_FALSE(negative_inf.Compare(inf, tolerance));
+  }
+  EXPECT_THROW(Tolerance::Ulp(-1), std::invalid_argument);
+}
+
+TEST(Matrix_operations, QuantizedHash) {
+  S21Matrix A(40, 40);
+  A.IntegerFillMatrix(-100, 100, 82);
+  S21Matrix B(A);
+  B(3, 4) += 1e-9;
+  EXPECT_EQ(A.QuantizedHash(1e-3), B.QuantizedHash(1e-3));
+  B(3, 4) += 1;
+  EXPECT_NE(A.QuantizedHash(1e-3), B.QuantizedHash(1e-3));
+  S21Matrix C(A);
+  C(0, 0) = 1;
+  C(0, 1) = 2;
+  S21Matrix D(C);
+  std::swap(D(0, 0), D(0, 1));
+  EXPECT_NE(C.QuantizedHash(), D.QuantizedHash());
+  EXPECT_NE(S21Matrix(2, 3).QuantizedHash(), S21Matrix(3, 2).QuantizedHash());
+  EXPECT_ANY_THROW({ A.QuantizedHash(0); });
+  // Dedup through a hash table keyed by the quantized hash.
+  std::unordered_map<std::uint64_t, int> seen;
+  for (int copy = 0; copy < 3; copy++) {
+    for (std::uint64_t seed = 0; seed < 10; seed++) {
+      S21Matrix M(5, 5);
+      M.IntegerFillMatrix(0, 9, seed);
+      seen[M.QuantizedHash(0.5)]++;
+    }
+  }
+  EXPECT_EQ(seen.size(), 10u);
+}
+
 TEST(Matrix_operations, Transpose_1) {
   S21Matrix A(3, 2);
   S21Matrix C(2, 3);
@@ -737,6 +1144,1010 @@ TEST(Matrix_operations, InverseMatrix_1) {
   });
 }
 
+S21Matrix HilbertMatrix(int n) {
+  S21Matrix result(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) result(i, j) = 1.0 / (i + j + 1);
+  }
+  return result;
+}
+
+S21Matrix DominantMatrix(int n, std::uint64_t seed) {
+  S21Matrix result(n, n);
+  result.UniformFillMatrix(-1, 1, seed);
+  for (int i = 0; i < n; i++) result(i, i) += n;
+  return result;
+}
+
+TEST(Matrix_operations, Solve_1) {
+  S21Matrix A = DominantMatrix(60, 3);
+  S21Matrix b(60, 2);
+  b.UniformFillMatrix(-5, 5, 4);
+  S21Matrix x = A.Solve(b);
+  EXPECT_TRUE(A * x == b);
+  S21Matrix x_mixed = A.Solve(b, S21Matrix::Precision::kMixed);
+  EXPECT_TRUE(x_mixed == x);
+}
+
+TEST(Matrix_operations, Solve_ill_conditioned_fallback) {
+  S21Matrix A = HilbertMatrix(9);
+  S21Matrix b(9, 1);
+  b.NumberFillMatrix(1);
+  S21Matrix x = A.Solve(b);
+  S21Matrix x_mixed = A.Solve(b, S21Matrix::Precision::kMixed);
+  EXPECT_TRUE(std::equal(x.begin(), x.end(), x_mixed.begin()));
+}
+
+TEST(Matrix_operations, Solve_out_of_float_range) {
+  S21Matrix A = DominantMatrix(4, 5) * 1e40;
+  S21Matrix b(4, 1);
+  b.UniformFillMatrix(-1, 1, 6);
+  S21Matrix x = A.Solve(b);
+  EXPECT_TRUE(std::isfinite(x.MaxAbs()));
+  S21Matrix x_mixed = A.Solve(b, S21Matrix::Precision::kMixed);
+  EXPECT_TRUE(std::equal(x.begin(), x.end(), x_mixed.begin()));
+  S21Matrix inverse = A.InverseMatrix(S21Matrix::Precision::kMixed);
+  EXPECT_TRUE(std::isfinite(inverse.MaxAbs()));
+  EXPECT_TRUE(inverse.Compare(A.InverseMatrix(),
+                              S21Matrix::Tolerance::Relative(1e-12)));
+  S21Matrix C(2, 2);
+  C(0, 1) = std::numeric_limits<double>::quiet_NaN();
+  C(1, 1) = 3;
+  EXPECT_TRUE(std::isnan(C.MaxAbs()));
+}
+
+TEST(Matrix_operations, Solve_exeption) {
+  S21Matrix b(3, 1);
+  EXPECT_ANY_THROW({ S21Matrix(3, 4).Solve(b); });
+  EXPECT_ANY_THROW({ S21Matrix(4, 4).Solve(b); });
+  EXPECT_ANY_THROW({ S21Matrix(3, 3).Solve(b); });
+  EXPECT_ANY_THROW(
+      { S21Matrix(3, 3).Solve(b, S21Matrix::Precision::kMixed); });
+}
+
+TEST(Matrix_operations, InverseMatrix_precision) {
+  double matrix[3][3] = {{2, 5, 7}, {6, 3, 4}, {5, -2, -3}};
+  double result[3][3] = {{1, -1, 1}, {-38, 41, -34}, {27, -29, 24}};
+  S21Matrix A(3, 3);
+  S21Matrix expected(3, 3);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) {
+      A(i, j) = matrix[i][j];
+      expected(i, j) = result[i][j];
+    }
+  }
+  EXPECT_TRUE(A.InverseMatrix(S21Matrix::Precision::kDouble) == expected);
+  EXPECT_TRUE(A.InverseMatrix(S21Matrix::Precision::kMixed) == expected);
+  S21Matrix B = DominantMatrix(40, 9);
+  S21Matrix identity(40, 40);
+  for (int i = 0; i < 40; i++) identity(i, i) = 1;
+  EXPECT_TRUE(B * B.InverseMatrix(S21Matrix::Precision::kMixed) == identity);
+}
+
+TEST(Matrix_operations, MulMatrix_compensated) {
+  // Row [1e16, 1, -1e16] times a column of ones: naive accumulation loses
+  // the 1 entirely.
+  S21Matrix A(1, 3);
+  A(0, 0) = 1e16;
+  A(0, 1) = 1;
+  A(0, 2) = -1e16;
+  S21Matrix B(3, 1);
+  B.NumberFillMatrix(1);
+  S21Matrix fast(A);
+  fast.MulMatrix(B);
+  EXPECT_EQ(fast(0, 0), 0);
+  S21Matrix exact(A);
+  exact.MulMatrix(B, S21Matrix::Accuracy::kCompensated);
+  EXPECT_EQ(exact(0, 0), 1);
+  S21Matrix C = DominantMatrix(50, 5);
+  S21Matrix D = DominantMatrix(50, 6);
+  S21Matrix CD(C);
+  CD.MulMatrix(D, S21Matrix::Accuracy::kCompensated);
+  EXPECT_TRUE(CD == C * D);
+}
+
+TEST(Reductions, sum_trace_norm_dot) {
+  S21Matrix A(3, 3);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) A(i, j) = i * 3 + j + 1;
+  }
+  for (S21Matrix::Accuracy accuracy :
+       {S21Matrix::Accuracy::kFast, S21Matrix::Accuracy::kCompensated}) {
+    EXPECT_EQ(A.Sum(accuracy), 45);
+    EXPECT_EQ(A.Trace(accuracy), 15);
+    EXPECT_DOUBLE_EQ(A.FrobeniusNorm(accuracy), std::sqrt(285.0));
+    EXPECT_EQ(A.Dot(A, accuracy), 285);
+  }
+  EXPECT_ANY_THROW({ S21Matrix(2, 3).Trace(); });
+  EXPECT_ANY_THROW({ A.Dot(S21Matrix(3, 2)); });
+}
+
+TEST(Reductions, norms_and_sums) {
+  S21Matrix A(2, 3);
+  double values[2][3] = {{1, -7, 3}, {-4, 5, 6}};
+  for (int i = 0; i < 2; i++) {
+    for (int j = 0; j < 3; j++) A(i, j) = values[i][j];
+  }
+  EXPECT_EQ(A.Norm1(), 12);
+  EXPECT_EQ(A.NormInf(), 15);
+  EXPECT_EQ(A.MaxAbs(), 7);
+  EXPECT_EQ(A.ArgMax(), std::make_pair(1, 2));
+  S21Matrix row_sums = A.RowSums();
+  EXPECT_EQ(row_sums.GetRows(), 2);
+  EXPECT_EQ(row_sums.GetCols(), 1);
+  EXPECT_EQ(row_sums(0, 0), -3);
+  EXPECT_EQ(row_sums(1, 0), 7);
+  S21Matrix col_sums = A.ColSums();
+  EXPECT_EQ(col_sums.GetRows(), 1);
+  EXPECT_EQ(col_sums(0, 0), -3);
+  EXPECT_EQ(col_sums(0, 1), -2);
+  EXPECT_EQ(col_sums(0, 2), 9);
+  EXPECT_EQ(A.RowMeans()(0, 0), -1);
+  EXPECT_EQ(A.ColMeans()(0, 2), 4.5);
+}
+
+TEST(Reductions, summary) {
+  S21Matrix A(300, 200);
+  A.UniformFillMatrix(-1, 1, 71);
+  A(123, 45) = 5;
+  A(250, 7) = -6;
+  S21Parallel::SetNumThreads(4);
+  S21Matrix::Summary summary = A.Summarize();
+  S21Parallel::SetNumThreads(0);
+  EXPECT_EQ(summary.max, 5);
+  EXPECT_EQ(summary.min, -6);
+  EXPECT_EQ(summary.max_abs, 6);
+  EXPECT_EQ(summary.argmax_row, 123);
+  EXPECT_EQ(summary.argmax_col, 45);
+  EXPECT_NEAR(summary.sum, A.Sum(S21Matrix::Accuracy::kCompensated), 1e-9);
+  EXPECT_NEAR(summary.sum_squares, A.Dot(A), 1e-9);
+  EXPECT_EQ(A.ArgMax(), std::make_pair(123, 45));
+  A(299, 199) = std::numeric_limits<double>::quiet_NaN();
+  S21Parallel::SetNumThreads(4);
+  summary = A.Summarize();
+  S21Parallel::SetNumThreads(0);
+  EXPECT_TRUE(std::isnan(summary.max_abs));
+  EXPECT_TRUE(std::isnan(A.MaxAbs()));
+}
+
+TEST(Reductions, compensated_large) {
+  S21Matrix A(1000, 1000);
+  A.NumberFillMatrix(0.1);
+  A(0, 0) = 1e10;
+  double expected = 1e10 + 0.1 * 999999;
+  EXPECT_DOUBLE_EQ(A.Sum(S21Matrix::Accuracy::kCompensated), expected);
+  EXPECT_NEAR(A.Sum(), expected, 1);
+}
+
+TEST(Async, member_operations) {
+  S21Matrix A = DominantMatrix(30, 11);
+  S21Matrix B = DominantMatrix(30, 12);
+  S21Future product = A.MulMatrixAsync(B);
+  S21Future sum = A.SumMatrixAsync(B);
+  S21Future difference = A.SubMatrixAsync(B);
+  S21Future inverse = A.InverseMatrixAsync();
+  S21Future solution = A.SolveAsync(B);
+  EXPECT_TRUE(product.Get() == A * B);
+  EXPECT_TRUE(sum.Get() == A + B);
+  EXPECT_TRUE(difference.Get() == A - B);
+  EXPECT_TRUE(inverse.Get() ==
+              A.InverseMatrix(S21Matrix::Precision::kDouble));
+  EXPECT_TRUE(solution.Get() == A.Solve(B));
+  EXPECT_TRUE(product.Ready());
+}
+
+TEST(Async, dependency_graph) {
+  S21Executor executor(3);
+  S21Matrix A = DominantMatrix(20, 21);
+  S21Matrix B = DominantMatrix(20, 22);
+  S21Future a = S21Executor::MakeReady(A);
+  S21Future b = executor.Submit([&B] { return B; });
+  // (A * B + A^T) * B^-1, submitted as one graph.
+  S21Future ab = S21Async::Mul(a, b, executor);
+  S21Future at = S21Async::Transpose(a, executor);
+  S21Future left = S21Async::Sum(ab, at, executor);
+  S21Future result = S21Async::Mul(left, S21Async::Inverse(b, executor),
+                                   executor);
+  S21Matrix expected =
+      (A * B + A.Transpose()) * B.InverseMatrix(S21Matrix::Precision::kDouble);
+  EXPECT_TRUE(result.Get() == expected);
+}
+
+TEST(Async, errors_propagate) {
+  S21Executor executor(2);
+  S21Future a = S21Executor::MakeReady(S21Matrix(2, 3));
+  S21Future bad = S21Async::Mul(a, a, executor);
+  S21Future dependent = S21Async::Transpose(bad, executor);
+  EXPECT_THROW(bad.Get(), std::out_of_range);
+  EXPECT_THROW(dependent.Get(), std::out_of_range);
+  EXPECT_ANY_THROW({ S21Async::Transpose(S21Future(), executor); });
+  EXPECT_FALSE(S21Future().Valid());
+}
+
+TEST(Structured, symmetric) {
+  S21Matrix A(7, 4);
+  A.UniformFillMatrix(-1, 1, 31);
+  S21SymmetricMatrix S = S21SymmetricMatrix::Syrk(A);
+  EXPECT_EQ(S.GetSize(), 7);
+  EXPECT_TRUE(S.ToMatrix() == A * A.Transpose());
+  S(2, 5) = 3;
+  EXPECT_EQ(S(5, 2), 3);
+  S21Matrix B(7, 3);
+  B.UniformFillMatrix(-1, 1, 32);
+  EXPECT_TRUE(S.MulMatrix(B) == S.ToMatrix() * B);
+  EXPECT_TRUE(S21SymmetricMatrix::FromMatrix(S.ToMatrix()).ToMatrix() ==
+              S.ToMatrix());
+  EXPECT_ANY_THROW({ S(7, 0); });
+  EXPECT_ANY_THROW({ S21SymmetricMatrix::FromMatrix(A); });
+}
+
+TEST(Structured, triangular) {
+  using Triangle = S21TriangularMatrix::Triangle;
+  S21Matrix A = DominantMatrix(9, 33);
+  for (Triangle triangle : {Triangle::kLower, Triangle::kUpper}) {
+    S21TriangularMatrix T = S21TriangularMatrix::FromMatrix(A, triangle);
+    S21Matrix dense = T.ToMatrix();
+    EXPECT_EQ(T.GetTriangle(), triangle);
+    EXPECT_NEAR(T.Determinant(), dense.Determinant(), 1e-6 * T.Determinant());
+    S21Matrix b(9, 2);
+    b.UniformFillMatrix(-3, 3, 34);
+    EXPECT_TRUE(dense * T.Solve(b) == b);
+    EXPECT_TRUE(T.MulMatrix(b) == dense * b);
+    EXPECT_TRUE(T.InverseMatrix().ToMatrix() ==
+                dense.InverseMatrix(S21Matrix::Precision::kDouble));
+  }
+  S21TriangularMatrix L(3, Triangle::kLower);
+  EXPECT_ANY_THROW({ L(0, 1) = 1; });
+  EXPECT_EQ(static_cast<const S21TriangularMatrix &>(L)(0, 1), 0);
+  EXPECT_ANY_THROW({ L.InverseMatrix(); });
+}
+
+TEST(Structured, band) {
+  S21Matrix A(10, 10);
+  A.UniformFillMatrix(-1, 1, 35);
+  S21BandMatrix band = S21BandMatrix::FromMatrix(A, 2, 1);
+  S21Matrix dense = band.ToMatrix();
+  EXPECT_EQ(dense(5, 2), 0);
+  EXPECT_EQ(dense(5, 3), A(5, 3));
+  EXPECT_EQ(dense(5, 6), A(5, 6));
+  EXPECT_EQ(dense(5, 7), 0);
+  S21Matrix B(10, 4);
+  B.UniformFillMatrix(-1, 1, 36);
+  EXPECT_TRUE(band.MulMatrix(B) == dense * B);
+  EXPECT_ANY_THROW({ band(0, 5) = 1; });
+  EXPECT_ANY_THROW({ S21BandMatrix(4, 4, 0); });
+  EXPECT_ANY_THROW({ band.MulMatrix(S21Matrix(3, 3)); });
+}
+
+S21Matrix SymmetricMatrix(int n, std::uint64_t seed) {
+  S21Matrix A(n, n);
+  A.UniformFillMatrix(-1, 1, seed);
+  return (A + A.Transpose()) * 0.5;
+}
+
+S21Matrix Diagonal(const std::vector<double> &values) {
+  int n = static_cast<int>(values.size());
+  S21Matrix result(n, n);
+  for (int i = 0; i < n; i++) result(i, i) = values[i];
+  return result;
+}
+
+S21Matrix Identity(int n) { return Diagonal(std::vector<double>(n, 1.0)); }
+
+TEST(Decomposition, symmetric_eigen) {
+  S21Matrix A = SymmetricMatrix(30, 41);
+  S21EigenResult eigen = A.SymmetricEigen();
+  ASSERT_EQ(eigen.values.size(), 30u);
+  EXPECT_TRUE(std::is_sorted(eigen.values.rbegin(), eigen.values.rend()));
+  EXPECT_TRUE(A * eigen.vectors == eigen.vectors * Diagonal(eigen.values));
+  EXPECT_TRUE(eigen.vectors.Transpose() * eigen.vectors == Identity(30));
+  EXPECT_NEAR(std::accumulate(eigen.values.begin(), eigen.values.end(), 0.0),
+              A.Trace(), 1e-9);
+  S21EigenResult packed = S21SymmetricMatrix::FromMatrix(A).Eigen();
+  for (int i = 0; i < 30; i++) {
+    EXPECT_NEAR(packed.values[i], eigen.values[i], 1e-12);
+  }
+  EXPECT_ANY_THROW({ S21Matrix(3, 4).SymmetricEigen(); });
+  S21Matrix B(3, 3);
+  B(0, 1) = 1;
+  EXPECT_ANY_THROW({ B.SymmetricEigen(); });
+}
+
+TEST(Decomposition, symmetric_eigen_top) {
+  // PSD matrix with a geometrically decaying spectrum.
+  int n = 80;
+  S21Matrix basis = SymmetricMatrix(n, 42).SymmetricEigen().vectors;
+  std::vector<double> spectrum(n);
+  for (int i = 0; i < n; i++) spectrum[i] = 100 * std::pow(0.5, i);
+  S21Matrix A = basis * Diagonal(spectrum) * basis.Transpose();
+  S21EigenResult top = A.SymmetricEigen(4);
+  ASSERT_EQ(top.values.size(), 4u);
+  EXPECT_EQ(top.vectors.GetCols(), 4);
+  for (int i = 0; i < 4; i++) EXPECT_NEAR(top.values[i], spectrum[i], 1e-8);
+  S21Matrix residual = A * top.vectors - top.vectors * Diagonal(top.values);
+  EXPECT_LT(residual.FrobeniusNorm(), 1e-6);
+  EXPECT_ANY_THROW({ A.SymmetricEigen(0); });
+  EXPECT_ANY_THROW({ A.SymmetricEigen(n + 1); });
+}
+
+TEST(Decomposition, svd) {
+  for (auto shape : {std::make_pair(12, 7), std::make_pair(7, 12)}) {
+    S21Matrix A(shape.first, shape.second);
+    A.UniformFillMatrix(-1, 1, 43);
+    S21SvdResult svd = A.Svd();
+    int r = std::min(shape.first, shape.second);
+    ASSERT_EQ(svd.singular_values.size(), static_cast<std::size_t>(r));
+    EXPECT_EQ(svd.u.GetCols(), r);
+    EXPECT_EQ(svd.v.GetCols(), r);
+    EXPECT_TRUE(std::is_sorted(svd.singular_values.rbegin(),
+                               svd.singular_values.rend()));
+    EXPECT_TRUE(svd.u * Diagonal(svd.singular_values) * svd.v.Transpose() ==
+                A);
+    EXPECT_TRUE(svd.u.Transpose() * svd.u == Identity(r));
+    EXPECT_TRUE(svd.v.Transpose() * svd.v == Identity(r));
+  }
+}
+
+TEST(Decomposition, svd_top) {
+  S21Matrix left(60, 5), right(5, 40);
+  left.NormalFillMatrix(0, 1, 44);
+  right.NormalFillMatrix(0, 1, 45);
+  S21Matrix A = left * right;
+  S21SvdResult full = A.Svd();
+  S21SvdResult top = A.Svd(5);
+  ASSERT_EQ(top.singular_values.size(), 5u);
+  for (int i = 0; i < 5; i++) {
+    EXPECT_NEAR(top.singular_values[i], full.singular_values[i], 1e-8);
+  }
+  EXPECT_LT(full.singular_values[5], 1e-10);
+  EXPECT_TRUE(top.u * Diagonal(top.singular_values) * top.v.Transpose() == A);
+  EXPECT_ANY_THROW({ A.Svd(41); });
+}
+
+TEST(Matrix_operations, MultiplyChain) {
+  S21Matrix A(50, 5), B(5, 100), C(100, 10), D(10, 3);
+  A.UniformFillMatrix(-1, 1, 51);
+  B.UniformFillMatrix(-1, 1, 52);
+  C.UniformFillMatrix(-1, 1, 53);
+  D.UniformFillMatrix(-1, 1, 54);
+  S21Matrix::ChainReport report;
+  S21Matrix result = S21Matrix::MultiplyChain({&A, &B, &C}, &report);
+  EXPECT_TRUE(result == A * B * C);
+  EXPECT_EQ(report.naive_flops, 2u * (50 * 5 * 100 + 50 * 100 * 10));
+  EXPECT_EQ(report.chosen_flops, 2u * (5 * 100 * 10 + 50 * 5 * 10));
+  EXPECT_EQ(report.order, "(A0(A1A2))");
+  EXPECT_TRUE(S21Matrix::MultiplyChain({&A, &B, &C, &D}) == A * B * C * D);
+  EXPECT_TRUE(S21Matrix::MultiplyChain({&A}, &report) == A);
+  EXPECT_EQ(report.chosen_flops, 0u);
+  EXPECT_ANY_THROW({ S21Matrix::MultiplyChain({}); });
+  EXPECT_ANY_THROW({ S21Matrix::MultiplyChain({&A, &C}); });
+}
+
+TEST(Matrix_operations, Pow) {
+  S21Matrix A(3, 3);
+  A.IntegerFillMatrix(-2, 2, 61);
+  S21Matrix expected = Identity(3);
+  for (int k = 0; k <= 13; k++) {
+    EXPECT_TRUE(A.Pow(k) == expected);
+    expected *= A;
+  }
+  S21Matrix B = DominantMatrix(6, 62);
+  EXPECT_TRUE(B.Pow(-3) * B.Pow(3) == Identity(6));
+  S21Matrix D = Diagonal({2, -1, 0.5});
+  EXPECT_TRUE(D.Pow(10) == Diagonal({1024, 1, 1.0 / 1024}));
+  EXPECT_ANY_THROW({ S21Matrix(2, 3).Pow(2); });
+  EXPECT_ANY_THROW({ S21Matrix(2, 2).Pow(-1); });
+}
+
+TEST(Matrix_operations, Pow_markov_chain) {
+  S21Matrix P(2, 2);
+  P(0, 0) = 0.9;
+  P(0, 1) = 0.1;
+  P(1, 0) = 0.5;
+  P(1, 1) = 0.5;
+  S21Matrix steady = P.Pow(1000);
+  for (int i = 0; i < 2; i++) {
+    EXPECT_NEAR(steady(i, 0), 5.0 / 6, 1e-12);
+    EXPECT_NEAR(steady(i, 1), 1.0 / 6, 1e-12);
+  }
+}
+
+TEST(Matrix_operations, Exp) {
+  EXPECT_TRUE(S21Matrix(4, 4).Exp() == Identity(4));
+  EXPECT_TRUE(Diagonal({1, -2}).Exp() == Diagonal({std::exp(1), std::exp(-2)}));
+  S21Matrix N(2, 2);
+  N(0, 1) = 3;
+  S21Matrix expected = Identity(2);
+  expected(0, 1) = 3;
+  EXPECT_TRUE(N.Exp() == expected);
+  double t = 7.5;
+  S21Matrix R(2, 2);
+  R(0, 1) = -t;
+  R(1, 0) = t;
+  S21Matrix rotation = R.Exp();
+  EXPECT_NEAR(rotation(0, 0), std::cos(t), 1e-12);
+  EXPECT_NEAR(rotation(0, 1), -std::sin(t), 1e-12);
+  EXPECT_NEAR(rotation(1, 0), std::sin(t), 1e-12);
+  S21Matrix A(5, 5);
+  A.UniformFillMatrix(-2, 2, 63);
+  EXPECT_TRUE(A.Exp() * (A * -1).Exp() == Identity(5));
+  EXPECT_ANY_THROW({ S21Matrix(2, 3).Exp(); });
+  S21Matrix infinite = Diagonal({HUGE_VAL, 0});
+  EXPECT_TRUE(infinite.Exp() == Diagonal({HUGE_VAL, 1}));
+  infinite(0, 1) = 1;
+  EXPECT_THROW(infinite.Exp(), std::invalid_argument);
+  infinite(0, 0) = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_THROW(infinite.Exp(), std::invalid_argument);
+}
+
+TEST(Caching, invalidated_on_mutation) {
+  double matrix[4][4] = {
+      {1, 2, 3, 4}, {5, 6, 7, 8}, {2, 6, 4, 8}, {3, 1, 1, 2}};
+  S21Matrix A(4, 4);
+  for (int i = 0; i < 4; i++) {
+    for (int j = 0; j < 4; j++) A(i, j) = matrix[i][j];
+  }
+  const std::uint64_t version = A.GetVersion();
+  EXPECT_NEAR(A.Determinant(), 72, 1e-9);
+  S21Matrix inverse = A.InverseMatrix();
+  EXPECT_DOUBLE_EQ(A.Determinant(), A.Determinant());
+  EXPECT_TRUE(A.InverseMatrix() == inverse);
+  EXPECT_EQ(A.GetVersion(), version);
+  A(3, 3) = 3;
+  EXPECT_GT(A.GetVersion(), version);
+  EXPECT_NEAR(A.Determinant(), 96, 1e-9);
+  EXPECT_FALSE(A.InverseMatrix() == inverse);
+  A.SetRows(3);
+  EXPECT_ANY_THROW(A.Determinant());
+  A.SetRows(4);
+  EXPECT_EQ(A.Determinant(), 0);
+  EXPECT_ANY_THROW(A.InverseMatrix());
+}
+
+TEST(Caching, kept_pointers_need_mark_modified) {
+  S21Matrix A(4, 4);
+  for (int i = 0; i < 4; i++) A(i, i) = 2;
+  double *data = A.Data();
+  S21Matrix::RowSpan row = A.Row(1);
+  EXPECT_EQ(A.Determinant(), 16);
+  data[0] = 10;
+  A.MarkModified();
+  EXPECT_EQ(A.Determinant(), 80);
+  EXPECT_EQ(A.Determinant(), S21Matrix(A).Determinant());
+  S21Matrix inverse = A.InverseMatrix();
+  row[1] = 4;
+  A.MarkModified();
+  EXPECT_EQ(A.InverseMatrix()(1, 1), 0.25);
+  EXPECT_TRUE(A.InverseMatrix() == S21Matrix(A).InverseMatrix());
+  EXPECT_FALSE(A.InverseMatrix() == inverse);
+}
+
+TEST(Caching, counted_per_operation) {
+  S21Matrix A(3, 3);
+  for (int i = 0; i < 3; i++) A(i, i) = 2;
+  const std::uint64_t version = A.GetVersion();
+  EXPECT_EQ(A[1][1], 2);
+  EXPECT_NE(A.Data(), nullptr);
+  EXPECT_EQ(A.Row(2)[2], 2);
+  EXPECT_NE(A.begin(), A.end());
+  EXPECT_EQ(A.GetVersion(), version);
+  EXPECT_EQ(A.Determinant(), 8);
+  A.MulNumber(2);
+  EXPECT_EQ(A.Determinant(), 64);
+  A.SumMatrix(A);
+  EXPECT_EQ(A.Determinant(), 512);
+  A.SubMatrix(S21Matrix(3, 3));
+  A.MulMatrix(A);
+  EXPECT_EQ(A.Determinant(), 512.0 * 512);
+  A.NumberFillMatrix(1);
+  EXPECT_EQ(A.Determinant(), 0);
+  EXPECT_GT(A.GetVersion(), version);
+}
+
+TEST(Caching, solves_reuse_factorization) {
+  S21Matrix A = DominantMatrix(50, 2);
+  const S21Matrix &view = A;
+  S21Matrix inverse = view.InverseMatrix();
+  S21Matrix b(50, 3);
+  b.UniformFillMatrix(-1, 1, 6);
+  EXPECT_TRUE(view.Solve(b) == inverse * b);
+  A.SumMatrix(Identity(50));
+  EXPECT_TRUE(A * A.InverseMatrix() == Identity(50));
+  EXPECT_TRUE(A * A.Solve(b) == b);
+  S21Matrix moved(std::move(A));
+  EXPECT_TRUE(moved * moved.InverseMatrix() == Identity(50));
+}
+
+TEST(LowRank, rank_update) {
+  S21Matrix A(4, 3);
+  A.UniformFillMatrix(-1, 1, 1);
+  S21Matrix u(4, 2);
+  S21Matrix v(3, 2);
+  u.UniformFillMatrix(-1, 1, 2);
+  v.UniformFillMatrix(-1, 1, 3);
+  S21Matrix expected = A + u * v.Transpose() * 2;
+  A.RankUpdate(u, v, 2);
+  EXPECT_TRUE(A == expected);
+  EXPECT_ANY_THROW(A.RankUpdate(v, u));
+}
+
+TEST(LowRank, cached_results_follow_updates) {
+  S21Matrix A = DominantMatrix(40, 4);
+  A.InverseMatrix();
+  A.Determinant();
+  for (int step = 0; step < 5; ++step) {
+    S21Matrix u(40, 1);
+    u(step * 7, 0) = 1;
+    S21Matrix v(40, 1);
+    v.UniformFillMatrix(-1, 1, step);
+    A.RankUpdate(u, v);
+    S21Matrix fresh(A);
+    EXPECT_TRUE(A.InverseMatrix() == fresh.InverseMatrix());
+    EXPECT_NEAR(A.Determinant(), fresh.Determinant(),
+                1e-9 * fabs(fresh.Determinant()));
+  }
+  S21Matrix u(40, 3);
+  S21Matrix v(40, 3);
+  u.UniformFillMatrix(-1, 1, 7);
+  v.UniformFillMatrix(-1, 1, 8);
+  A.RankUpdate(u, v, 0.5);
+  S21Matrix b(40, 2);
+  b.UniformFillMatrix(-1, 1, 9);
+  EXPECT_TRUE(A * A.Solve(b) == b);
+  EXPECT_TRUE(A * A.InverseMatrix() == Identity(40));
+}
+
+TEST(LowRank, cholesky_update_downdate) {
+  S21Matrix a(30, 40);
+  a.UniformFillMatrix(-1, 1, 5);
+  S21SymmetricMatrix S = S21SymmetricMatrix::Syrk(a);
+  S21Cholesky cholesky(S);
+  S21Matrix L = cholesky.GetFactor().ToMatrix();
+  EXPECT_TRUE(L * L.Transpose() == S.ToMatrix());
+  S21Matrix b(30, 2);
+  b.UniformFillMatrix(-1, 1, 6);
+  EXPECT_TRUE(S.MulMatrix(cholesky.Solve(b)) == b);
+  EXPECT_NEAR(cholesky.Determinant(), S.ToMatrix().Determinant(),
+              1e-9 * cholesky.Determinant());
+  S21Matrix x(30, 1);
+  x.UniformFillMatrix(-1, 1, 7);
+  cholesky.Update(x);
+  L = cholesky.GetFactor().ToMatrix();
+  EXPECT_TRUE(L * L.Transpose() == S.ToMatrix() + x * x.Transpose());
+  cholesky.Downdate(x);
+  L = cholesky.GetFactor().ToMatrix();
+  EXPECT_TRUE(L * L.Transpose() == S.ToMatrix());
+  EXPECT_ANY_THROW(cholesky.Downdate(x * 100));
+  EXPECT_TRUE(cholesky.GetFactor().ToMatrix() == L);
+  S(0, 0) = -1;
+  EXPECT_ANY_THROW({ S21Cholesky failed(S); });
+}
+
+// Vandermonde matrix of the nodes 1..n: det = prod_{i<j} (j - i).
+S21Int64Matrix Vandermonde(int n) {
+  S21Int64Matrix result(n, n);
+  for (int i = 0; i < n; i++) {
+    std::int64_t power = 1;
+    for (int j = 0; j < n; j++, power *= i + 1) result(i, j) = power;
+  }
+  return result;
+}
+
+TEST(Integer, bareiss_determinant) {
+  std::int64_t expected = 1;
+  for (int i = 1; i < 9; i++) {
+    for (int factor = 2; factor <= i; factor++) expected *= factor;
+  }
+  EXPECT_EQ(Vandermonde(9).Determinant(), expected);
+  EXPECT_THROW(Vandermonde(12).Determinant(), std::overflow_error);
+  double matrix[3][3] = {{0, 2, 3}, {0, 5, 6}, {7, 8, 9}};
+  S21Matrix A(3, 3);
+  for (int i = 0; i < 3; i++) {
+    for (int j = 0; j < 3; j++) A(i, j) = matrix[i][j];
+  }
+  EXPECT_EQ(S21Int64Matrix::FromMatrix(A).Determinant(), -21);
+  A(0, 0) = 0.5;
+  EXPECT_ANY_THROW(S21Int64Matrix::FromMatrix(A));
+  S21Int64Matrix big(1, 1);
+  big(0, 0) = std::numeric_limits<std::int64_t>::max();
+  EXPECT_THROW(big + big, std::overflow_error);
+}
+
+TEST(Integer, modular_elimination) {
+  using Field = S21ModInt<998244353>;
+  S21Int64Matrix V = Vandermonde(12);
+  S21ModularMatrix<998244353> M(12, 12);
+  for (int i = 0; i < 12; i++) {
+    for (int j = 0; j < 12; j++) M(i, j) = V(i, j);
+  }
+  Field expected = 1;
+  for (int i = 1; i < 12; i++) {
+    for (int factor = 2; factor <= i; factor++) expected *= factor;
+  }
+  EXPECT_TRUE(M.Determinant() == expected);
+  S21ModularMatrix<998244353> identity(12, 12);
+  for (int i = 0; i < 12; i++) identity(i, i) = 1;
+  EXPECT_TRUE(M * M.InverseMatrix() == identity);
+  EXPECT_EQ(M.Rank(), 12);
+  for (int j = 0; j < 12; j++) M(11, j) = M(0, j) * 3 - M(1, j);
+  EXPECT_EQ(M.Rank(), 11);
+  EXPECT_TRUE(M.Determinant() == 0);
+  EXPECT_ANY_THROW(M.InverseMatrix());
+  EXPECT_TRUE(Field(-1) == Field(998244352));
+  EXPECT_TRUE(Field(5) * Field(5).Inverse() == 1);
+}
+
+TEST(Integer, modular_product_delayed_reduction) {
+  const std::uint32_t kPrime = 2147483647;
+  S21ModularMatrix<kPrime> A(3, 50);
+  S21ModularMatrix<kPrime> B(50, 2);
+  for (int p = 0; p < 50; p++) {
+    for (int i = 0; i < 3; i++) A(i, p) = -1;
+    for (int j = 0; j < 2; j++) B(p, j) = -1 - j;
+  }
+  S21ModularMatrix<kPrime> C = A * B;
+  EXPECT_EQ(C(0, 0).Value(), 50u);
+  EXPECT_EQ(C(2, 1).Value(), 100u);
+  S21Matrix X(20, 30);
+  S21Matrix Y(30, 10);
+  X.IntegerFillMatrix(-1000, 1000, 1);
+  Y.IntegerFillMatrix(-1000, 1000, 2);
+  S21Int64Matrix exact =
+      S21Int64Matrix::FromMatrix(X) * S21Int64Matrix::FromMatrix(Y);
+  EXPECT_TRUE(exact.ToMatrix() == X * Y);
+  S21ModularMatrix<101> modular = S21ModularMatrix<101>::FromMatrix(X) *
+                                  S21ModularMatrix<101>::FromMatrix(Y);
+  for (int i = 0; i < 20; i++) {
+    for (int j = 0; j < 10; j++) {
+      EXPECT_TRUE(modular(i, j) == S21ModInt<101>(exact(i, j)));
+    }
+  }
+}
+
+TEST(Status, try_operations) {
+  S21Matrix A(2, 3);
+  A.NumberFillMatrix(1);
+  S21Matrix B(3, 2);
+  const std::uint64_t version = A.GetVersion();
+  EXPECT_EQ(A.TrySumMatrix(B), S21Status::kDimensionMismatch);
+  EXPECT_EQ(A.TrySubMatrix(B), S21Status::kDimensionMismatch);
+  EXPECT_EQ(A.TryMulMatrix(A), S21Status::kProductMismatch);
+  EXPECT_EQ(A.GetVersion(), version);
+  EXPECT_EQ(A.TrySumMatrix(A), S21Status::kOk);
+  EXPECT_EQ(A(1, 2), 2);
+  EXPECT_EQ(A.TryMulMatrix(B), S21Status::kOk);
+  EXPECT_EQ(A.GetRows(), 2);
+  EXPECT_EQ(A.GetCols(), 2);
+  EXPECT_EQ(A.TryAt(-1, 0), nullptr);
+  EXPECT_EQ(A.TryAt(0, 2), nullptr);
+  ASSERT_NE(A.TryAt(1, 1), nullptr);
+  *A.TryAt(1, 1) = 5;
+  EXPECT_EQ(A(1, 1), 5);
+  EXPECT_EQ(S21Matrix::TryCreate(0, 3).GetStatus(), S21Status::kInvalidSize);
+  S21Result<S21Matrix> created = S21Matrix::TryCreate(4, 1);
+  ASSERT_TRUE(created.Ok());
+  EXPECT_EQ(created->GetRows(), 4);
+}
+
+TEST(Status, try_solvers) {
+  S21Matrix A(3, 4);
+  EXPECT_EQ(A.TryDeterminant().GetStatus(), S21Status::kNotSquare);
+  EXPECT_EQ(A.TryInverseMatrix().GetStatus(), S21Status::kNotSquare);
+  S21Matrix singular(3, 3);
+  EXPECT_EQ(singular.TryInverseMatrix().GetStatus(), S21Status::kSingular);
+  S21Matrix large(5, 5);
+  EXPECT_EQ(large.TryInverseMatrix().GetStatus(), S21Status::kSingular);
+  EXPECT_EQ(large.TrySolve(A).GetStatus(), S21Status::kDimensionMismatch);
+  S21Matrix D = DominantMatrix(6, 1);
+  S21Result<S21Matrix> inverse = D.TryInverseMatrix();
+  ASSERT_TRUE(inverse);
+  EXPECT_TRUE(*inverse == D.InverseMatrix());
+  EXPECT_DOUBLE_EQ(*D.TryDeterminant(), D.Determinant());
+  EXPECT_EQ(singular.TryDeterminant().ValueOr(-1), 0);
+  EXPECT_EQ(A.TryDeterminant().ValueOr(-1), -1);
+  EXPECT_THROW(A.TryDeterminant().ValueOrThrow(), std::out_of_range);
+  EXPECT_THROW(S21Throw(S21Status::kOverflow), std::overflow_error);
+  EXPECT_THROW(S21Throw(S21Status::kInvalidArgument), std::invalid_argument);
+  EXPECT_THROW(S21Throw(S21Status::kNotConverged), std::runtime_error);
+  EXPECT_STREQ(S21StatusMessage(S21Status::kNotSquare),
+               "The matrix is not square.");
+}
+
+// Full correlation by definition, element by element.
+S21Matrix NaiveCorrelate(const S21Matrix &a, const S21Matrix &k) {
+  int p = k.GetRows();
+  int q = k.GetCols();
+  S21Matrix full(a.GetRows() + p - 1, a.GetCols() + q - 1);
+  for (int i = 0; i < full.GetRows(); ++i) {
+    for (int j = 0; j < full.GetCols(); ++j) {
+      for (int u = 0; u < p; ++u) {
+        for (int v = 0; v < q; ++v) {
+          int ai = i + u - (p - 1);
+          int aj = j + v - (q - 1);
+          if (ai >= 0 && ai < a.GetRows() && aj >= 0 && aj < a.GetCols()) {
+            full(i, j) += a(ai, aj) * k(u, v);
+          }
+        }
+      }
+    }
+  }
+  return full;
+}
+
+TEST(Convolution, known_values) {
+  using Mode = S21Matrix::ConvolutionMode;
+  S21Matrix A(2, 2);
+  std::iota(A.begin(), A.end(), 1.0);
+  S21Matrix K(2, 2);
+  std::iota(K.begin(), K.end(), 0.0);
+  std::vector<double> full = {0, 1, 2, 2, 10, 10, 6, 17, 12};
+  S21Matrix C = A.Convolve2D(K);
+  EXPECT_EQ(C.GetRows(), 3);
+  EXPECT_TRUE(std::equal(C.begin(), C.end(), full.begin(), full.end()));
+  std::vector<double> same = {0, 1, 2, 10};
+  C = A.Convolve2D(K, Mode::kSame);
+  EXPECT_TRUE(std::equal(C.begin(), C.end(), same.begin(), same.end()));
+  C = A.Convolve2D(K, Mode::kValid);
+  EXPECT_EQ(C.GetRows(), 1);
+  EXPECT_EQ(C.GetCols(), 1);
+  EXPECT_EQ(C(0, 0), 10);
+  std::reverse(K.begin(), K.end());
+  C = A.Correlate2D(K);
+  EXPECT_TRUE(std::equal(C.begin(), C.end(), full.begin(), full.end()));
+  EXPECT_THROW(K.Convolve2D(S21Matrix(3, 1), Mode::kValid),
+               std::out_of_range);
+}
+
+TEST(Convolution, methods_agree) {
+  using Mode = S21Matrix::ConvolutionMode;
+  using Method = S21Matrix::ConvolutionMethod;
+  S21Matrix A(23, 37);
+  A.NormalFillMatrix(0, 1, 5);
+  for (std::pair<int, int> shape : {std::make_pair(1, 1), std::make_pair(3, 2),
+                                    std::make_pair(6, 11),
+                                    std::make_pair(23, 37)}) {
+    S21Matrix K(shape.first, shape.second);
+    K.NormalFillMatrix(0, 1, 6);
+    S21Matrix full = NaiveCorrelate(A, K);
+    for (Mode mode : {Mode::kFull, Mode::kSame, Mode::kValid}) {
+      for (Method method :
+           {Method::kAuto, Method::kDirect, Method::kIm2col, Method::kFft}) {
+        S21Matrix C = A.Correlate2D(K, mode, method);
+        int row = 0;
+        int col = 0;
+        if (mode == Mode::kSame) {
+          row = (K.GetRows() - 1) / 2;
+          col = (K.GetCols() - 1) / 2;
+        } else if (mode == Mode::kValid) {
+          row = K.GetRows() - 1;
+          col = K.GetCols() - 1;
+        }
+        S21Matrix expected(C.GetRows(), C.GetCols());
+        for (int i = 0; i < C.GetRows(); ++i) {
+          for (int j = 0; j < C.GetCols(); ++j) {
+            expected(i, j) = full(row + i, col + j);
+          }
+        }
+        EXPECT_TRUE(C.Compare(expected, S21Matrix::Tolerance::Absolute(1e-9)));
+      }
+    }
+  }
+}
+
+TEST(Convolution, large_kernel) {
+  using Method = S21Matrix::ConvolutionMethod;
+  S21Matrix A(150, 130);
+  A.UniformFillMatrix(-1, 1, 7);
+  S21Matrix K(41, 45);
+  K.UniformFillMatrix(-1, 1, 8);
+  S21Matrix direct = A.Convolve2D(K, S21Matrix::ConvolutionMode::kSame,
+                                  Method::kDirect);
+  EXPECT_TRUE(A.Convolve2D(K, S21Matrix::ConvolutionMode::kSame)
+                  .Compare(direct, S21Matrix::Tolerance::Absolute(1e-9)));
+}
+
+TEST(Distributed, shared_memory) {
+  S21Matrix A(70, 300);
+  A.NormalFillMatrix(0, 1, 11);
+  S21Matrix B(300, 90);
+  B.NormalFillMatrix(0, 1, 12);
+  S21Matrix expected = A * B;
+  for (int processes : {1, 4, 6}) {
+    S21SharedMemoryTransport transport(1 << 12);
+    S21Matrix C(A);
+    C.MulMatrixDistributed(B, transport, processes);
+    EXPECT_TRUE(C.Compare(expected, S21Matrix::Tolerance::Absolute(1e-9)));
+  }
+}
+
+TEST(Distributed, tcp) {
+  S21Matrix A(3, 400);
+  A.UniformFillMatrix(-1, 1, 13);
+  S21Matrix B(400, 20);
+  B.UniformFillMatrix(-1, 1, 14);
+  S21TcpTransport transport;
+  S21Matrix C(A);
+  C.MulMatrixDistributed(B, transport, 9);
+  EXPECT_TRUE(C.Compare(A * B, S21Matrix::Tolerance::Absolute(1e-9)));
+  EXPECT_THROW(C.MulMatrixDistributed(A, transport, 2), std::out_of_range);
+  EXPECT_THROW(A.MulMatrixDistributed(B, transport, 0), std::invalid_argument);
+}
+
+// Kills rank 2 before it joins, as a crashing worker would.
+class DyingTransport : public S21SharedMemoryTransport {
+ public:
+  void Attach(int rank) override {
+    if (rank == 2) _exit(1);
+    S21SharedMemoryTransport::Attach(rank);
+  }
+};
+
+TEST(Distributed, worker_failure) {
+  S21Matrix A(40, 40);
+  A.NumberFillMatrix(1);
+  DyingTransport transport;
+  EXPECT_THROW(A.MulMatrixDistributed(A, transport, 4), std::runtime_error);
+  EXPECT_EQ(A(0, 0), 1);
+}
+
+// The i-k-j reference every product kernel has to match exactly.
+S21Matrix NaiveProduct(const S21Matrix &a, const S21Matrix &b) {
+  S21Matrix result(a.GetRows(), b.GetCols());
+  for (int i = 0; i < a.GetRows(); ++i) {
+    for (int p = 0; p < a.GetCols(); ++p) {
+      for (int j = 0; j < b.GetCols(); ++j) result(i, j) += a(i, p) * b(p, j);
+    }
+  }
+  return result;
+}
+
+TEST(Kernels, shapes_match_reference) {
+  const int shapes[][3] = {{3, 3, 20},   {5, 1, 7},     {6, 8, 13},
+                           {40, 12, 5},  {1000, 17, 3}, {2, 300, 100},
+                           {3, 8, 5000}, {70, 65, 90},  {130, 300, 270}};
+  S21Parallel::SetNumThreads(4);
+  for (const auto &shape : shapes) {
+    S21Matrix A(shape[0], shape[1]);
+    S21Matrix B(shape[1], shape[2]);
+    A.UniformFillMatrix(-1, 1, 81);
+    B.UniformFillMatrix(-1, 1, 82);
+    S21Matrix C = A * B;
+    S21Matrix expected = NaiveProduct(A, B);
+    EXPECT_TRUE(std::equal(C.begin(), C.end(), expected.begin()))
+        << shape[0] << " x " << shape[1] << " x " << shape[2];
+  }
+  S21Parallel::SetNumThreads(0);
+}
+
+TEST(Kernels, autotune_persists) {
+  const std::string path = "test_kernels.tuning";
+  std::remove(path.c_str());
+  S21Kernels::SetTuningFile(path);
+  S21Kernels::SetAutotune(true);
+  S21Matrix A(64, 200);
+  S21Matrix B(200, 96);
+  A.UniformFillMatrix(-1, 1, 83);
+  B.UniformFillMatrix(-1, 1, 84);
+  S21Matrix C = A * B;
+  S21Matrix expected = NaiveProduct(A, B);
+  EXPECT_TRUE(std::equal(C.begin(), C.end(), expected.begin()));
+  S21Kernels::Tiles tuned = S21Kernels::GetTiles(64, 200, 96);
+  std::ifstream file(path);
+  int m = 0, k = 0, n = 0, tile_k = 0, tile_n = 0;
+  EXPECT_TRUE(file >> m >> k >> n >> tile_k >> tile_n);
+  EXPECT_EQ(tile_k, tuned.k);
+  EXPECT_EQ(tile_n, tuned.n);
+  S21Kernels::ClearTuning();
+  S21Kernels::Tiles loaded = S21Kernels::GetTiles(64, 200, 96);
+  EXPECT_EQ(loaded.k, tuned.k);
+  EXPECT_EQ(loaded.n, tuned.n);
+  S21Kernels::SetAutotune(false);
+  S21Kernels::SetTuningFile("s21_matrix.tuning");
+  std::remove(path.c_str());
+}
+
+TEST(Kernels, tuning_file_skips_corrupt_lines) {
+  const std::string path = "test_kernels_corrupt.tuning";
+  {
+    std::ofstream file(path);
+    file << "6 7 six 8 8\n"
+         << "# not a tuning line\n"
+         << "6 7 6 24 40\n"
+         << "4 4 4 16\n"
+         << "4 4 4 0 8\n"
+         << "5 5 5 32 48\n";
+  }
+  S21Kernels::SetTuningFile(path);
+  S21Kernels::SetAutotune(true);
+  S21Kernels::Tiles tiles = S21Kernels::GetTiles(64, 200, 96);
+  EXPECT_EQ(tiles.k, 24);
+  EXPECT_EQ(tiles.n, 40);
+  tiles = S21Kernels::GetTiles(32, 32, 32);
+  EXPECT_EQ(tiles.k, 32);
+  EXPECT_EQ(tiles.n, 48);
+  S21Kernels::SetAutotune(false);
+  S21Kernels::SetTuningFile("s21_matrix.tuning");
+  std::remove(path.c_str());
+}
+
+// Square matrices of the differential sweep by kind: well conditioned,
+// with two nearly dependent rows, Hilbert, rows scaled over many orders of
+// magnitude, and singular with small integer elements, so that the
+// reference finds a zero determinant exactly.
+S21Matrix SweepMatrix(int n, int kind, std::uint64_t seed) {
+  if (kind == 2) return HilbertMatrix(n);
+  S21Matrix result(n, n);
+  if (kind == 4) {
+    result.IntegerFillMatrix(-9, 9, seed);
+  } else {
+    result.UniformFillMatrix(-1, 1, seed);
+  }
+  for (int j = 0; j < n && n > 1; ++j) {
+    if (kind == 1) result(n - 1, j) = result(0, j) + 1e-9 * result(n - 1, j);
+    if (kind == 4) result(n - 1, j) = result(0, j);
+  }
+  for (int i = 0; i < n && kind == 3; ++i) {
+    for (double &value : result.Row(i)) value *= std::ldexp(1, 12 * i - 6 * n);
+  }
+  return result;
+}
+
+TEST(Reference, known_values) {
+  S21Matrix A(3, 3);
+  double values[] = {2, 5, 7, 6, 3, 4, 5, -2, -3};
+  std::copy(values, values + 9, A.begin());
+  EXPECT_EQ(S21Reference::Determinant(A), -1);
+  S21Matrix inverse(3, 3);
+  double inverse_values[] = {1, -1, 1, -38, 41, -34, 27, -29, 24};
+  std::copy(inverse_values, inverse_values + 9, inverse.begin());
+  EXPECT_TRUE(S21Reference::Inverse(A) == inverse);
+  S21Matrix identity(3, 3);
+  for (int i = 0; i < 3; i++) identity(i, i) = 1;
+  EXPECT_TRUE(S21Reference::Multiply(A, inverse) == identity);
+  EXPECT_EQ(S21Reference::ConditionNumber(HilbertMatrix(1)), 1);
+  EXPECT_EQ(HilbertMatrix(1).InverseMatrix()(0, 0), 1);
+  EXPECT_EQ(S21Reference::ConditionNumber(SweepMatrix(5, 4, 1)), HUGE_VAL);
+  EXPECT_NEAR(S21Reference::Determinant(HilbertMatrix(4)), 1.0 / 6048000,
+              1e-18);
+  EXPECT_THROW(S21Reference::Inverse(SweepMatrix(5, 4, 1)), std::out_of_range);
+  EXPECT_THROW(S21Reference::Determinant(S21Matrix(11, 11)),
+               std::invalid_argument);
+}
+
+TEST(Reference, product_sweep) {
+  for (int threads : {1, 2, 4}) {
+    S21Parallel::SetNumThreads(threads);
+    for (std::uint64_t seed = 0; seed < 24; ++seed) {
+      S21Matrix dims(1, 3);
+      dims.IntegerFillMatrix(1, seed % 3 ? 12 : 150, seed);
+      int m = static_cast<int>(dims(0, 0));
+      int k = static_cast<int>(dims(0, 1));
+      int n = static_cast<int>(dims(0, 2));
+      S21Matrix A(m, k);
+      S21Matrix B(k, n);
+      A.NormalFillMatrix(0, seed % 2 ? 1 : 1e6, 2 * seed);
+      B.NormalFillMatrix(0, 1, 2 * seed + 1);
+      EXPECT_EQ(S21Reference::CheckProduct(A, B), "") << threads;
+    }
+  }
+  S21Parallel::SetNumThreads(0);
+  EXPECT_EQ(S21Reference::CheckProduct(S21Matrix(2, 3), S21Matrix(2, 3)), "");
+}
+
+TEST(Reference, determinant_inverse_sweep) {
+  for (int threads : {1, 4}) {
+    S21Parallel::SetNumThreads(threads);
+    for (int n = 1; n <= S21Reference::kMaxCofactorSize; ++n) {
+      for (int kind = 0; kind < 5; ++kind) {
+        S21Matrix A = SweepMatrix(n, kind, 10 * n + kind);
+        EXPECT_EQ(S21Reference::CheckDeterminant(A), "") << n << " " << kind;
+        EXPECT_EQ(S21Reference::CheckInverse(A), "") << n << " " << kind;
+      }
+    }
+  }
+  S21Parallel::SetNumThreads(0);
+}
+
 int main(int argc, char **argv) {
   srand(time(NULL));
   ::testing::InitGoogleTest(&argc, argv);